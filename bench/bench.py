@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""
+Barrido de escalado de los programas del repositorio.
+
+Uso (normalmente a través de CMake: cmake --build build --target bench):
+  python3 bench/bench.py --bin=build [--salida=build/bench] [opciones]
+
+Para cada programa recorre cantidades de hilos y tamaños, repite cada corrida
+y guarda mediana, desviación estándar, speedup y eficiencia paralela en
+<salida>/resultados.csv y <salida>/resultados.json.
+
+  escalado fuerte  tamaño fijo, más hilos
+  escalado debil   tamaño proporcional a los hilos (tam_base * hilos)
+
+Referencia del speedup (siempre con el mismo tamaño de problema):
+  pi (busy_waiting1/2, mutex, pi_mt)  pi_seq, es decir secuencial.cpp con su
+                                      kernel escalar original
+  matvec_mt, lista_mt                 el mismo programa y variante con 1 hilo
+                                      (no hay versión secuencial aparte)
+  eficiencia = speedup / hilos
+
+lock_bench ya hace su propio barrido; su CSV se guarda tal cual en
+<salida>/lock_bench.csv y en la sección "lock_bench" del JSON.
+
+Opciones:
+  --hilos=1,2,4        cantidades de hilos (por defecto potencias de 2 hasta nproc)
+  --repeticiones=R     corridas medidas por punto (5; 3 con --rapido)
+  --calentamiento=C    corridas descartadas antes de medir (1)
+  --programas=p,...    pi, matvec, lista, locks (por defecto todos)
+  --timeout=S          segundos máximos por corrida (120); si se pasa, el punto
+                       queda con estado "timeout"
+  --rapido             tamaños chicos, para comprobar que todo corre
+"""
+
+import argparse
+import csv
+import datetime
+import json
+import os
+import platform
+import re
+import statistics
+import subprocess
+import sys
+
+RE_PI = re.compile(r"Tiempo de ejecución:\s*([0-9.eE+-]+)")
+RE_MATVEC_LLAMADA = re.compile(r"latencia media por llamada:\s*([0-9.eE+-]+) ms")
+RE_MATVEC_TOTAL = re.compile(r"Tiempo total:\s*([0-9.eE+-]+) s")
+
+
+def tiempo_pi(salida):
+    m = RE_PI.search(salida)
+    return float(m.group(1)) if m else None
+
+
+def tiempo_matvec(salida):
+    # --rhs: tabla "k, ms por pasada, ..." con una fila por k; se toma la primera.
+    lineas = salida.splitlines()
+    for i, linea in enumerate(lineas):
+        if linea.startswith("k, ms por pasada") and i + 1 < len(lineas):
+            return float(lineas[i + 1].split(",")[1]) / 1000.0
+    m = RE_MATVEC_LLAMADA.search(salida)
+    if m:
+        return float(m.group(1)) / 1000.0
+    m = RE_MATVEC_TOTAL.search(salida)
+    return float(m.group(1)) if m else None
+
+
+def tiempo_lista(salida):
+    filas = list(csv.DictReader(salida.splitlines()))
+    return float(filas[0]["tiempo_s"]) if filas else None
+
+
+class Corredor:
+    """Ejecuta los binarios y guarda en caché los tiempos ya medidos."""
+
+    def __init__(self, bin_dir, repeticiones, calentamiento, timeout):
+        self.bin_dir = bin_dir
+        self.repeticiones = repeticiones
+        self.calentamiento = calentamiento
+        self.timeout = timeout
+        self.cache = {}
+
+    def una(self, argv, extraer):
+        ruta = os.path.join(self.bin_dir, argv[0])
+        try:
+            r = subprocess.run([ruta] + [str(a) for a in argv[1:]], capture_output=True,
+                               text=True, timeout=self.timeout)
+        except subprocess.TimeoutExpired:
+            return None, "timeout"
+        if r.returncode != 0:
+            return None, "error %d" % r.returncode
+        t = extraer(r.stdout)
+        return (t, "ok") if t is not None else (None, "sin tiempo")
+
+    def medir(self, argv, extraer):
+        """Devuelve (tiempos, estado). Cada argv se mide una sola vez."""
+        clave = tuple(str(a) for a in argv)
+        if clave in self.cache:
+            return self.cache[clave]
+        for _ in range(self.calentamiento):
+            t, estado = self.una(argv, extraer)
+            if t is None:
+                self.cache[clave] = ([], estado)
+                return self.cache[clave]
+        tiempos = []
+        for _ in range(self.repeticiones):
+            t, estado = self.una(argv, extraer)
+            if t is None:
+                self.cache[clave] = ([], estado)
+                return self.cache[clave]
+            tiempos.append(t)
+        self.cache[clave] = (tiempos, "ok")
+        return self.cache[clave]
+
+
+def fila_omitida(programa, variante, escalado, tam, hilos, estado):
+    return {"programa": programa, "variante": variante, "escalado": escalado, "tam": tam,
+            "hilos": hilos, "repeticiones": 0, "mediana_s": None, "desv_s": None,
+            "min_s": None, "max_s": None, "referencia": None, "ref_mediana_s": None,
+            "speedup": None, "eficiencia": None, "estado": estado}
+
+
+def fila(corredor, programa, variante, escalado, tam, hilos, argv, extraer, ref_argv, ref_extraer):
+    tiempos, estado = corredor.medir(argv, extraer)
+    f = fila_omitida(programa, variante, escalado, tam, hilos, estado)
+    f["repeticiones"] = len(tiempos)
+    f["referencia"] = " ".join(str(a) for a in ref_argv)
+    if tiempos:
+        f["mediana_s"] = statistics.median(tiempos)
+        f["desv_s"] = statistics.stdev(tiempos) if len(tiempos) > 1 else 0.0
+        f["min_s"], f["max_s"] = min(tiempos), max(tiempos)
+        ref, _ = corredor.medir(ref_argv, ref_extraer)
+        if ref:
+            f["ref_mediana_s"] = statistics.median(ref)
+            if f["mediana_s"] > 0:
+                f["speedup"] = f["ref_mediana_s"] / f["mediana_s"]
+                f["eficiencia"] = f["speedup"] / hilos
+    imprimir(f)
+    return f
+
+
+def imprimir(f):
+    def num(v, fmt):
+        return fmt % v if v is not None else "-"
+    print("%-14s %-18s %-6s %12s %4d  %10s s  ±%9s  speedup %7s  ef. %6s  %s" % (
+        f["programa"], f["variante"], f["escalado"], f["tam"], f["hilos"],
+        num(f["mediana_s"], "%.5f"), num(f["desv_s"], "%.5f"),
+        num(f["speedup"], "%.2f"), num(f["eficiencia"], "%.2f"),
+        "" if f["estado"] == "ok" else f["estado"]), flush=True)
+
+
+def barrido_pi(c, hilos, rapido):
+    filas = []
+    n_fuerte = 20_000_000 if rapido else 400_000_000
+    n_debil = 5_000_000 if rapido else 100_000_000      # términos por hilo
+    n_turno = 20_000 if rapido else 200_000             # busy_waiting1: turno por término
+
+    variantes = [
+        ("busy_waiting2", "busy-fuera", lambda p, n: ["busy_waiting2", p, n]),
+        ("mutex", "mutex", lambda p, n: ["mutex", p, n]),
+    ]
+    for estrategia in ["busy-fuera", "mutex", "cas", "arbol"]:
+        variantes.append(("pi_mt", estrategia, lambda p, n, e=estrategia: ["pi_mt", e, p, n]))
+    variantes.append(("pi_mt", "arbol+auto", lambda p, n: ["pi_mt", "arbol", p, n, "--kernel=auto"]))
+
+    for programa, variante, argv in variantes:
+        for p in hilos:
+            filas.append(fila(c, programa, variante, "fuerte", n_fuerte, p, argv(p, n_fuerte), tiempo_pi,
+                              ["pi_seq", n_fuerte], tiempo_pi))
+        for p in hilos:
+            n = n_debil * p
+            filas.append(fila(c, programa, variante, "debil", n, p, argv(p, n), tiempo_pi,
+                              ["pi_seq", n], tiempo_pi))
+
+    # Un turno por término: sólo con un tamaño chico y escalado fuerte. Con más
+    # hilos que núcleos cada turno cuesta un quantum del planificador (el hilo
+    # de turno no está corriendo), así que esos puntos no se corren.
+    for p in hilos:
+        if p > (os.cpu_count() or 1):
+            f = fila_omitida("busy_waiting1", "busy-dentro", "fuerte", n_turno, p, "omitido: hilos > núcleos")
+            imprimir(f)
+            filas.append(f)
+            continue
+        filas.append(fila(c, "busy_waiting1", "busy-dentro", "fuerte", n_turno, p,
+                          ["busy_waiting1", p, n_turno], tiempo_pi, ["pi_seq", n_turno], tiempo_pi))
+    return filas
+
+
+def barrido_matvec(c, hilos, rapido):
+    filas = []
+    lado = 1000 if rapido else 6000
+    filas_base = 500 if rapido else 2000                # filas por hilo en escalado débil
+    iters = 5 if rapido else 20
+    variantes = [
+        ("dinamica", ["--planificacion=dinamica"]),
+        ("estatica", ["--planificacion=estatica"]),
+        ("rhs8", ["--rhs=8"]),
+    ]
+    for variante, extra in variantes:
+        def argv(p, f, col, extra=extra):
+            return ["matvec_mt", f, col, p, "--iteraciones=%d" % iters] + extra
+        for p in hilos:
+            filas.append(fila(c, "matvec_mt", variante, "fuerte", "%dx%d" % (lado, lado), p,
+                              argv(p, lado, lado), tiempo_matvec, argv(1, lado, lado), tiempo_matvec))
+        for p in hilos:
+            f = filas_base * p
+            filas.append(fila(c, "matvec_mt", variante, "debil", "%dx%d" % (f, lado), p,
+                              argv(p, f, lado), tiempo_matvec, argv(1, f, lado), tiempo_matvec))
+    return filas
+
+
+def barrido_lista(c, hilos, rapido):
+    filas = []
+    ops_total = 200_000 if rapido else 2_000_000
+    ops_hilo = 50_000 if rapido else 500_000            # escalado débil
+    mezcla = [80, 10, 10]
+    init_n, key_max, semilla = 1000, 2000, 42
+    for estrategia in ["coarse", "fine", "rw", "lockfree", "hash"]:
+        def argv(p, ops, e=estrategia):
+            return ["lista_mt", e, p, ops] + mezcla + [init_n, key_max, semilla, "--formato=csv", "--muestreo=0"]
+        for p in hilos:
+            ops = ops_total // p
+            filas.append(fila(c, "lista_mt", estrategia, "fuerte", ops * p, p,
+                              argv(p, ops), tiempo_lista, argv(1, ops * p), tiempo_lista))
+        for p in hilos:
+            filas.append(fila(c, "lista_mt", estrategia, "debil", ops_hilo * p, p,
+                              argv(p, ops_hilo), tiempo_lista, argv(1, ops_hilo * p), tiempo_lista))
+    return filas
+
+
+def barrido_locks(c, hilos, rapido):
+    argv = [os.path.join(c.bin_dir, "lock_bench"), "todos", str(max(hilos)), "--formato=csv",
+            "--ops=%d" % (20_000 if rapido else 1_000_000), "--relevos=%d" % (2_000 if rapido else 100_000)]
+    try:
+        r = subprocess.run(argv, capture_output=True, text=True, timeout=c.timeout * 10)
+    except subprocess.TimeoutExpired:
+        print("lock_bench: timeout", flush=True)
+        return "", []
+    if r.returncode != 0:
+        print("lock_bench: error %d" % r.returncode, flush=True)
+    print(r.stdout, end="", flush=True)
+    return r.stdout, list(csv.DictReader(r.stdout.splitlines()))
+
+
+def potencias_hasta(n):
+    v, p = [], 1
+    while p < n:
+        v.append(p)
+        p *= 2
+    v.append(n)
+    return v
+
+
+def commit_actual():
+    try:
+        return subprocess.run(["git", "rev-parse", "--short", "HEAD"], capture_output=True, text=True,
+                              cwd=os.path.dirname(os.path.abspath(__file__))).stdout.strip() or None
+    except OSError:
+        return None
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Barrido de escalado de los programas del repositorio")
+    ap.add_argument("--bin", required=True, help="directorio con los ejecutables")
+    ap.add_argument("--salida", default="bench", help="directorio de resultados")
+    ap.add_argument("--hilos", help="lista de hilos, p. ej. 1,2,4,8")
+    ap.add_argument("--repeticiones", type=int)
+    ap.add_argument("--calentamiento", type=int, default=1)
+    ap.add_argument("--programas", default="pi,matvec,lista,locks")
+    ap.add_argument("--timeout", type=float, default=120.0)
+    ap.add_argument("--rapido", action="store_true")
+    a = ap.parse_args()
+
+    nproc = os.cpu_count() or 1
+    hilos = [int(h) for h in a.hilos.split(",")] if a.hilos else potencias_hasta(nproc)
+    repeticiones = a.repeticiones or (3 if a.rapido else 5)
+    programas = a.programas.split(",")
+    desconocidos = set(programas) - {"pi", "matvec", "lista", "locks"}
+    if desconocidos or min(hilos) < 1 or repeticiones < 1:
+        ap.error("argumentos inválidos: %s" % (", ".join(sorted(desconocidos)) or "hilos/repeticiones"))
+
+    c = Corredor(os.path.abspath(a.bin), repeticiones, a.calentamiento, a.timeout)
+    print("Hilos: %s, repeticiones: %d, núcleos: %d%s" % (
+        hilos, repeticiones, nproc, ", modo rápido" if a.rapido else ""), flush=True)
+
+    filas, lock_csv, lock_filas = [], "", []
+    if "pi" in programas:
+        filas += barrido_pi(c, hilos, a.rapido)
+    if "matvec" in programas:
+        filas += barrido_matvec(c, hilos, a.rapido)
+    if "lista" in programas:
+        filas += barrido_lista(c, hilos, a.rapido)
+    if "locks" in programas:
+        lock_csv, lock_filas = barrido_locks(c, hilos, a.rapido)
+
+    os.makedirs(a.salida, exist_ok=True)
+    columnas = ["programa", "variante", "escalado", "tam", "hilos", "repeticiones", "mediana_s", "desv_s",
+                "min_s", "max_s", "referencia", "ref_mediana_s", "speedup", "eficiencia", "estado"]
+    with open(os.path.join(a.salida, "resultados.csv"), "w", newline="") as f:
+        w = csv.DictWriter(f, fieldnames=columnas)
+        w.writeheader()
+        w.writerows(filas)
+    if lock_csv:
+        with open(os.path.join(a.salida, "lock_bench.csv"), "w") as f:
+            f.write(lock_csv)
+    meta = {
+        "fecha": datetime.datetime.now().isoformat(timespec="seconds"),
+        "host": platform.node(),
+        "cpu": platform.processor() or platform.machine(),
+        "nucleos": nproc,
+        "commit": commit_actual(),
+        "hilos": hilos,
+        "repeticiones": repeticiones,
+        "calentamiento": a.calentamiento,
+        "rapido": a.rapido,
+    }
+    with open(os.path.join(a.salida, "resultados.json"), "w") as f:
+        json.dump({"meta": meta, "resultados": filas, "lock_bench": lock_filas}, f, indent=2, ensure_ascii=False)
+
+    fallidas = [f for f in filas if f["estado"] != "ok"]
+    print("\nResultados en %s (%d puntos, %d sin medir)" % (os.path.abspath(a.salida), len(filas), len(fallidas)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
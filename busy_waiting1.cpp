@@ -11,6 +11,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <chrono>
+#include <atomic>
 
 using namespace std;
 using namespace chrono;
@@ -19,7 +20,9 @@ using namespace chrono;
 long long n;              // Total de términos
 int thread_count;         // Número de hilos
 double sum = 0.0;         // Suma global
-int flag = 0;             // Bandera para controlar turno
+// Bandera de turno. Atómica: con un int común el while (flag != my_rank) es
+// una carrera de datos y el compilador puede leerla una sola vez fuera del bucle.
+atomic<int> flag(0);
 
 void* Thread_sum(void* rank) {
     long my_rank = (long) rank;
@@ -33,7 +36,7 @@ void* Thread_sum(void* rank) {
             // Mostrar espera activa cada 50,000 iteraciones (ajustable)
             if (i % 50000 == 0) {
                 printf("🕒 Hilo %ld esperando turno en i = %lld (flag = %d)\n",
-                       my_rank, i, flag);
+                       my_rank, i, flag.load());
             }
         }
 
@@ -49,7 +52,7 @@ void* Thread_sum(void* rank) {
         }
 
         // Pasa el turno al siguiente hilo
-        flag = (flag + 1) % thread_count;
+        flag.store((flag.load() + 1) % thread_count);
     }
 
     // Fin del hilo
@@ -3,7 +3,9 @@
  * ✅ Incluye salida para demostrar el control de turno al final (no en cada iteración)
  * 
  * Compilar: g++ -g -Wall -o busy_waiting2 busy_waiting2.cpp -lpthread
- * Ejecutar: ./busy_waiting2 <num_threads> <num_terminos>
+ * Ejecutar: ./busy_waiting2 <num_threads> <num_terminos> [kernel]
+ *   kernel: escalar (por defecto) | pares | avx2 | avx2-rcp | avx512 | avx512-rcp |
+ *           auto (leibniz.hpp); cada hilo lo aplica a su bloque de términos
  */
 
 #include <iostream>
@@ -11,6 +13,9 @@
 #include <cstdlib>
 #include <cmath>
 #include <chrono>
+#include <string>
+#include <atomic>
+#include "leibniz.hpp"
 
 using namespace std;
 using namespace chrono;
@@ -18,8 +23,9 @@ using namespace chrono;
 // Variables globales compartidas
 long long n;
 int thread_count;
+InfoLeibniz kernel;     // kernel de leibniz.hpp para la suma local
 double sum = 0.0;
-int flag = 0;  // turno de los hilos
+atomic<int> flag(0);  // turno de los hilos (atómico: leerlo mientras otro lo escribe es una carrera)
 
 void* Thread_sum(void* rank) {
     long my_rank = (long) rank;
@@ -28,17 +34,13 @@ void* Thread_sum(void* rank) {
     long long my_last_i = my_first_i + my_n;
 
     // 1. Cada hilo calcula su suma local sin interferencia
-    double my_sum = 0.0;
-    for (long long i = my_first_i; i < my_last_i; i++) {
-        double factor = (i % 2 == 0) ? 1.0 : -1.0;
-        my_sum += factor / (2 * i + 1);
-    }
+    double my_sum = kernel.f(my_first_i, my_last_i);
 
     printf("🧮 Hilo %ld terminó su suma local: %.6f\n", my_rank, my_sum);
 
     // 2. Busy-waiting FUERA del bucle: espera una sola vez su turno para actualizar sum
     while (flag != my_rank) {
-        printf("🕒 Hilo %ld esperando turno para actualizar sum (flag = %d)\n", my_rank, flag);
+        printf("🕒 Hilo %ld esperando turno para actualizar sum (flag = %d)\n", my_rank, flag.load());
     }
 
     // 3. Sección crítica: actualiza la suma global
@@ -46,20 +48,26 @@ void* Thread_sum(void* rank) {
     printf("✅ Hilo %ld actualizó sum: %.6f → nueva sum = %.6f\n", my_rank, my_sum, sum);
 
     // 4. Cede el turno
-    flag = (flag + 1) % thread_count;
+    flag.store((flag.load() + 1) % thread_count);
 
     printf("✅✅ Hilo %ld terminó\n", my_rank);
     return NULL;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        cerr << "Uso: " << argv[0] << " <num_threads> <num_terminos>\n";
+    if (argc != 3 && argc != 4) {
+        cerr << "Uso: " << argv[0] << " <num_threads> <num_terminos> [kernel]\n";
         return 1;
     }
 
     thread_count = atoi(argv[1]);
     n = atoll(argv[2]);
+    string nombre = argc == 4 ? argv[3] : "escalar";
+    kernel = elegir_leibniz(nombre);
+    if (!kernel.f) {
+        cerr << "Kernel desconocido o no soportado por esta CPU: " << nombre << "\n";
+        return 1;
+    }
 
     pthread_t* thread_handles = new pthread_t[thread_count];
 
@@ -78,6 +86,9 @@ int main(int argc, char* argv[]) {
     cout.precision(15);
     cout << "\n🔢 Estimación de π: " << pi_estimate << endl;
     cout << "⏱️  Tiempo de ejecución: " << elapsed.count() << " segundos" << endl;
+    cout.precision(6);
+    cout << "🚀 Términos por segundo: " << n / elapsed.count() / 1e6 << " M (kernel " << kernel.nombre << ")" << endl;
+    cout.precision(15);
     cout << "🎯 Valor real de π: " << M_PI << endl;
 
     delete[] thread_handles;
@@ -0,0 +1,205 @@
+// matvec_mpi.cpp
+// Multiplicación matriz–vector distribuida con MPI (opcionalmente MPI + hilos)
+// Compilar: mpicxx -O2 -std=c++17 -pthread -o matvec_mpi matvec_mpi.cpp
+//
+// Uso:
+//   mpirun -np <procesos> ./matvec_mpi <n_filas> <n_columnas> [opciones]
+//   El rango 0 genera A y x con los mismos valores que matvec_mt (semilla 42),
+//   reparte A por bloques de filas (MPI_Scatterv), difunde x (MPI_Bcast), cada
+//   proceso calcula su parte de y y el rango 0 la junta (MPI_Gatherv).
+//   opciones:
+//     --hilos=T         hilos por proceso para el bloque local (1; MPI_THREAD_FUNNELED)
+//     --iteraciones=N   repetir Bcast + cálculo + Gatherv N veces; si A es cuadrada,
+//                       iteración de potencia (x = y / ||y|| en el rango 0)
+//     --verificar       el rango 0 recalcula la última y en secuencial y compara
+// Ejemplo:
+//   mpirun -np 4 ./matvec_mpi 8000 8000
+//   mpirun -np 2 ./matvec_mpi 8000 8000 --hilos=2 --iteraciones=20 --verificar
+//   En una sola máquina Open MPI usa memoria compartida (vader) entre procesos;
+//   con menos núcleos que procesos hace falta --oversubscribe.
+//
+// Reporta el máximo entre procesos de cada fase: reparto de A (una vez), Bcast
+// de x, cálculo y Gatherv de y, para ver cuánto pesa la comunicación.
+
+#include <bits/stdc++.h>
+#include <mpi.h>
+using namespace std;
+
+// Filas [first, last) de la parte p de n repartidas en `partes`.
+static pair<int, int> bloque(int n, int partes, int p) {
+    int base = n / partes, resto = n % partes;
+    int first = p * base + min(p, resto);
+    return {first, first + base + (p < resto ? 1 : 0)};
+}
+
+// Producto punto con cuatro acumuladores para no quedar atado a la latencia de la suma.
+static double dot(const double* a, const double* x, int m) {
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int j = 0;
+    for (; j + 4 <= m; j += 4) {
+        s0 += a[j] * x[j];
+        s1 += a[j + 1] * x[j + 1];
+        s2 += a[j + 2] * x[j + 2];
+        s3 += a[j + 3] * x[j + 3];
+    }
+    for (; j < m; ++j) s0 += a[j] * x[j];
+    return (s0 + s1) + (s2 + s3);
+}
+
+// y[0..filas) = A_local · x, repartiendo las filas entre `hilos` hilos.
+static void matvec_local(const double* A, const double* x, double* y, int filas, int m, int hilos) {
+    auto trabajo = [&](int h) {
+        auto [f0, f1] = bloque(filas, hilos, h);
+        for (int i = f0; i < f1; ++i) y[i] = dot(A + (size_t)i * m, x, m);
+    };
+    if (hilos == 1) { trabajo(0); return; }
+    vector<thread> pool;
+    for (int h = 0; h < hilos; ++h) pool.emplace_back(trabajo, h);
+    for (auto& t : pool) t.join();
+}
+
+int main(int argc, char** argv) {
+    int provisto;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provisto);
+    int rank, procesos;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &procesos);
+
+    // Todos validan lo mismo; sólo el rango 0 imprime el error.
+    string error;
+    int n = 0, m = 0, hilos = 1, iteraciones = 1;
+    bool verificar = false;
+    if (argc < 3) {
+        error = string("Uso: mpirun -np <procesos> ") + argv[0]
+              + " <n_filas> <n_columnas> [--hilos=T] [--iteraciones=N] [--verificar]";
+    } else {
+        n = atoi(argv[1]);
+        m = atoi(argv[2]);
+        for (int a = 3; a < argc && error.empty(); ++a) {
+            string op = argv[a];
+            if (op.rfind("--hilos=", 0) == 0) hilos = atoi(op.c_str() + 8);
+            else if (op.rfind("--iteraciones=", 0) == 0) iteraciones = atoi(op.c_str() + 14);
+            else if (op == "--verificar") verificar = true;
+            else error = "Opcion desconocida: " + op;
+        }
+    }
+    if (error.empty() && (n < 1 || m < 1 || hilos < 1 || iteraciones < 1))
+        error = "n_filas, n_columnas, --hilos y --iteraciones deben ser >= 1";
+    if (error.empty() && hilos > 1 && provisto < MPI_THREAD_FUNNELED)
+        error = "La biblioteca MPI no soporta MPI_THREAD_FUNNELED";
+    if (!error.empty()) {
+        if (rank == 0) cerr << error << "\n";
+        MPI_Finalize();
+        return 1;
+    }
+
+    // --- Reparto por bloques de filas ---
+    // A se reparte en unidades de una fila (m doubles contiguos): cuentas y
+    // desplazamientos son números de fila y caben en int aunque n*m no quepa.
+    vector<int> cuenta(procesos), despl(procesos);
+    for (int p = 0; p < procesos; ++p) {
+        auto [f0, f1] = bloque(n, procesos, p);
+        cuenta[p] = f1 - f0;
+        despl[p] = f0;
+    }
+    MPI_Datatype fila;
+    MPI_Type_contiguous(m, MPI_DOUBLE, &fila);
+    MPI_Type_commit(&fila);
+    int mis_filas = cuenta[rank];
+
+    // --- Datos: sólo el rango 0 tiene A completa y la y completa ---
+    vector<double> A, y, x(m), A_local, y_local;
+    if (rank == 0) {
+        mt19937 gen(42);
+        uniform_real_distribution<double> dist(0.0, 1.0);
+        A.resize((size_t)n * m);
+        for (double& a : A) a = dist(gen);
+        for (double& v : x) v = dist(gen);
+        y.resize(n);
+    } else {
+        A_local.resize((size_t)mis_filas * m);
+        y_local.resize(mis_filas);
+    }
+
+    // El bloque del rango 0 son sus primeras filas: lo usa en el lugar (MPI_IN_PLACE).
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+    if (rank == 0)
+        MPI_Scatterv(A.data(), cuenta.data(), despl.data(), fila,
+                     MPI_IN_PLACE, cuenta[0], fila, 0, MPI_COMM_WORLD);
+    else
+        MPI_Scatterv(nullptr, nullptr, nullptr, fila,
+                     A_local.data(), mis_filas, fila, 0, MPI_COMM_WORLD);
+    double t_reparto = MPI_Wtime() - t0;
+    const double* mi_A = rank == 0 ? A.data() : A_local.data();
+    // Igual con y: el rango 0 escribe sus filas directamente al principio de y
+    // y el Gatherv en el lugar sólo trae las de los demás.
+    double* mi_y = rank == 0 ? y.data() : y_local.data();
+
+    // --- Bucle: Bcast x, cálculo local, Gatherv y ---
+    // Iteración de potencia como en matvec_mt: con A cuadrada, x <- y / ||y||
+    // entre llamadas y ||y|| converge al mayor valor propio (en módulo).
+    bool potencia = iteraciones > 1 && n == m;
+    double t_bcast = 0, t_calculo = 0, t_gather = 0, norma = 0;
+    vector<double> x_ultimo;
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t_inicio = MPI_Wtime();
+    for (int it = 0; it < iteraciones; ++it) {
+        double a = MPI_Wtime();
+        MPI_Bcast(x.data(), m, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        double b = MPI_Wtime();
+        matvec_local(mi_A, x.data(), mi_y, mis_filas, m, hilos);
+        double c = MPI_Wtime();
+        if (rank == 0)
+            MPI_Gatherv(MPI_IN_PLACE, cuenta[0], MPI_DOUBLE,
+                        y.data(), cuenta.data(), despl.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        else
+            MPI_Gatherv(y_local.data(), mis_filas, MPI_DOUBLE,
+                        nullptr, nullptr, nullptr, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        double d = MPI_Wtime();
+        t_bcast += b - a; t_calculo += c - b; t_gather += d - c;
+
+        if (rank == 0) {
+            if (verificar && it == iteraciones - 1) x_ultimo = x;
+            if (potencia) {
+                norma = sqrt(inner_product(y.begin(), y.end(), y.begin(), 0.0));
+                if (it + 1 < iteraciones)
+                    for (int j = 0; j < m; ++j) x[j] = y[j] / norma;
+            }
+        }
+    }
+    double t_total = MPI_Wtime() - t_inicio;
+
+    double mios[5] = {t_reparto, t_bcast, t_calculo, t_gather, t_total}, maximos[5];
+    MPI_Reduce(mios, maximos, 5, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        double comunicacion = maximos[1] + maximos[3];
+        double gflops = 2.0 * n * m * iteraciones / maximos[4] / 1e9;
+        cout << "Matriz: " << n << "x" << m << ", Procesos: " << procesos << ", Hilos por proceso: " << hilos
+             << ", Iteraciones: " << iteraciones << "\n";
+        cout << "Reparto de A (Scatterv): " << maximos[0] << " s ("
+             << (double)n * m * sizeof(double) / maximos[0] / 1e9 << " GB/s)\n";
+        cout << "Tiempo total: " << maximos[4] << " s, por iteracion: " << maximos[4] / iteraciones * 1e3 << " ms\n";
+        cout << "  Bcast x:   " << maximos[1] << " s\n";
+        cout << "  Calculo:   " << maximos[2] << " s\n";
+        cout << "  Gatherv y: " << maximos[3] << " s\n";
+        cout << "Comunicacion / (comunicacion + calculo): "
+             << 100.0 * comunicacion / (comunicacion + maximos[2]) << " %\n";
+        cout << "Rendimiento: " << gflops << " GFLOP/s\n";
+        if (potencia) cout << "Valor propio dominante estimado (||A·x||): " << norma << "\n";
+        if (verificar) {
+            double dif = 0;
+            for (int i = 0; i < n; ++i)
+                dif = max(dif, fabs(y[i] - dot(A.data() + (size_t)i * m, x_ultimo.data(), m)));
+            cout << "Verificacion: diferencia maxima con el calculo secuencial = " << dif << "\n";
+        }
+        cout << "Primeros 5 valores de y: ";
+        for (int i = 0; i < min(5, n); ++i) cout << y[i] << " ";
+        cout << "\n";
+    }
+
+    MPI_Type_free(&fila);
+    MPI_Finalize();
+    return 0;
+}
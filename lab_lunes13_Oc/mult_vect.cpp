@@ -4,21 +4,351 @@
 // Compilar: g++ -O2 -std=c++17 -pthread -o matvec_mt matvec_mt.cpp
 //
 // Uso:
-//   ./matvec_mt <n_filas> <n_columnas> <threads>
+//   ./matvec_mt <n_filas> <n_columnas> <threads> [opciones]
+//   opciones:
+//     --anidada         A como vector<vector<double>> (formato anterior, para comparar)
+//     --kernel=<k>      auto (por defecto: el mejor que soporte la CPU) | escalar |
+//                       sse2 | avx2 | avx512
+//     --modo=gemm       C = A·B en vez de y = A·x (A es n_filas x n_columnas)
+//     --cols-b=P        columnas de B en modo gemm (por defecto n_columnas)
+//     --sin-ingenuo     no ejecutar el triple bucle de referencia en modo gemm
+//     --iteraciones=N   repetir la multiplicación N veces (iteración de potencia
+//                       si la matriz es cuadrada) y reportar latencia por llamada
+//     --planificacion=<p> dinamica (por defecto: trozos de filas con contador
+//                       atómico) | estatica (reparto fijo rows_per_thread)
+//     --bloque=R        filas por trozo en planificación dinámica (por defecto 64)
+//     --sin-pool        crear hilos nuevos en cada llamada (comportamiento anterior)
+//     --primer-toque    cada hilo inicializa su bloque de filas (páginas en su nodo
+//                       NUMA); implica planificación estática salvo que se pida otra
+//     --afinidad=<a>    ninguna (por defecto) | compacta (llenar un socket antes de
+//                       pasar al siguiente) | dispersa (alternar sockets y núcleos)
+//     --modo=spmv       y = A·x con A dispersa (aleatoria o leída de --mtx)
+//     --formato=<f>     en spmv: csr (por defecto) | sell (SELL-8-sigma) | ell
+//     --densidad=D      fracción de no ceros de la matriz aleatoria (por defecto 0.001)
+//     --sesgo=S         sesgo del largo de filas: la fila de rango r tiene peso
+//                       1/r^S (0 = todas iguales, por defecto 0)
+//     --sigma=S         ventana de ordenamiento de filas en SELL (por defecto 256)
+//     --reparto=<r>     en spmv: nnz (por defecto, igual número de no ceros por
+//                       hilo) | filas (igual número de filas)
+//     --mtx=archivo     leer A de un Matrix Market (coordinate); ignora n_filas y
+//                       n_columnas
+//     --comparar-densa  en spmv, medir también el kernel denso con la misma matriz
+//     --escribir-bin=archivo  guardar A (ya inicializada) en formato binario
+//     --bin=archivo     mapear A desde un archivo binario (mmap, sin copia); ignora
+//                       n_filas y n_columnas
+//     --prefault        con --bin, recorrer las páginas en paralelo antes de medir
+//     --escribir-y=archivo  y se escribe directamente en un archivo binario mapeado
+//                       (n x 1, ld = 1; --bin lo vuelve a leer copiándolo)
+//     --stream=archivo  A no se carga: se lee por paneles de filas desde un archivo
+//                       binario (lector dedicado + doble buffer) mientras los hilos
+//                       calculan el panel anterior; ignora n_filas y n_columnas
+//     --panel=R         filas por panel en --stream (por defecto ~32 MB por panel)
+//     --precision=<p>   double (por defecto) | float (todo en float) | mixta (A en
+//                       float, x y acumulación en double) | bf16 (A en bfloat16,
+//                       x y acumulación en float); reporta el error contra double
+//     --rhs=K[,K2,...]  Y = A·X con K vectores por pasada sobre A; con una lista
+//                       se mide cada K y se reporta el rendimiento en función de K
 // Ejemplo:
 //   ./matvec_mt 2000 2000 4
+//   ./matvec_mt 1024 1024 4 --modo=gemm
+//   ./matvec_mt 20000 20000 4 --escribir-bin=A.bin
+//   ./matvec_mt 0 0 4 --bin=A.bin --prefault --escribir-y=y.bin
+//   ./matvec_mt 0 0 4 --stream=A.bin --panel=2048
+//   ./matvec_mt 8000 8000 4 --precision=mixta --iteraciones=20
+//   ./matvec_mt 4000 4000 4 --rhs=1,2,4,8,16,32,64
+//   ./matvec_mt 200000 200000 4 --modo=spmv --formato=sell --densidad=0.0001 --sesgo=1
 
 #include <iostream>
 #include <vector>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
 #include <chrono>
 #include <random>
+#include <string>
+#include <algorithm>
+#include <tuple>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <pthread.h>
+#include <sched.h>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <immintrin.h>
 
 using namespace std;
 using namespace chrono;
 
+// ===== Memoria alineada =====
+// Asignador para vector<> con bloques alineados a línea de caché (64 B).
+template <class T>
+struct Alineado {
+    using value_type = T;
+    static constexpr size_t ALINEACION = 64;
+    Alineado() = default;
+    template <class U> Alineado(const Alineado<U>&) {}
+    T* allocate(size_t n) {
+        size_t bytes = (n * sizeof(T) + ALINEACION - 1) / ALINEACION * ALINEACION;
+        void* p = aligned_alloc(ALINEACION, bytes);
+        if (!p) throw bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, size_t) { free(p); }
+    // vector<T>(n) no escribe nada: las páginas quedan sin tocar hasta que las
+    // inicialice el hilo que las va a usar (primer toque). Quien necesite ceros
+    // los pide explícitamente, como MatrizDensa.
+    template <class U> void construct(U* p) { ::new ((void*)p) U; }
+    template <class U, class... Args> void construct(U* p, Args&&... args) {
+        ::new ((void*)p) U(std::forward<Args>(args)...);
+    }
+    template <class U> bool operator==(const Alineado<U>&) const { return true; }
+    template <class U> bool operator!=(const Alineado<U>&) const { return false; }
+};
+
+using VecAlineado = vector<double, Alineado<double>>;
+
+// ===== Matriz densa contigua =====
+// Fila-mayor en un solo bloque. ld (leading dimension) se redondea para que
+// cada fila ocupe un múltiplo de 64 B (8 doubles, 16 floats, 32 bf16), así
+// cada fila empieza alineada a 64 B; el relleno queda en 0.
+// Con 'externo' la matriz es una vista sobre memoria ajena (un archivo mapeado).
+template <class T>
+struct MatrizDensaT {
+    static constexpr size_t POR_LINEA = 64 / sizeof(T);
+
+    int filas, cols;
+    size_t ld;
+    vector<T, Alineado<T>> datos;
+    T* externo = nullptr;
+
+    MatrizDensaT(int n, int m)
+        : filas(n), cols(m), ld(redondear(m)), datos((size_t)n * ld, T{}) {}
+
+    // Sin inicializar: cada fila (incluido su relleno) la escribe quien la use.
+    struct SinTocar {};
+    MatrizDensaT(int n, int m, SinTocar)
+        : filas(n), cols(m), ld(redondear(m)), datos((size_t)n * ld) {}
+
+    MatrizDensaT(int n, int m, size_t ld_, T* datos_externos)
+        : filas(n), cols(m), ld(ld_), externo(datos_externos) {}
+
+    T* fila(int i) { return (externo ? externo : datos.data()) + (size_t)i * ld; }
+    const T* fila(int i) const { return (externo ? externo : datos.data()) + (size_t)i * ld; }
+
+    static size_t redondear(int m) { return ((size_t)m + POR_LINEA - 1) / POR_LINEA * POR_LINEA; }
+};
+
+using MatrizDensa = MatrizDensaT<double>;
+
+// ===== Formato binario =====
+// Cabecera de 64 B seguida de los datos crudos (double little-endian, filas de
+// ld elementos con el relleno incluido) a partir de 'desplazamiento', que es
+// múltiplo de 4096: al mapear el archivo cada fila queda alineada igual que en
+// memoria y los kernels la leen sin copiarla.
+struct CabeceraBin {
+    char magia[8];              // "MATVEC01"
+    uint32_t version;           // 1
+    uint32_t tipo;              // 1 = double
+    int64_t filas, cols, ld;
+    uint64_t alineacion;        // alineación de los datos dentro del archivo
+    uint64_t desplazamiento;    // inicio de los datos
+    uint64_t reservado;
+};
+static_assert(sizeof(CabeceraBin) == 64, "la cabecera ocupa 64 B");
+
+const char BIN_MAGIA[8] = { 'M', 'A', 'T', 'V', 'E', 'C', '0', '1' };
+const uint64_t BIN_ALINEACION = 4096;
+
+// Archivo binario mapeado en memoria (solo lectura con abrir(), lectura y
+// escritura compartida con crear()). Se desmapea al destruirse.
+class ArchivoMatriz {
+public:
+    ArchivoMatriz() = default;
+    ArchivoMatriz(const ArchivoMatriz&) = delete;
+    ArchivoMatriz& operator=(const ArchivoMatriz&) = delete;
+    ~ArchivoMatriz() { cerrar(); }
+
+    bool abrir(const string& ruta, string& error) {
+        fd = open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) { error = "no se pudo abrir " + ruta + ": " + strerror(errno); return false; }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CabeceraBin)) { error = "archivo demasiado corto"; return false; }
+        largo = (size_t)st.st_size;
+        if (!mapear(PROT_READ, error)) return false;
+        const CabeceraBin& c = cabecera();
+        if (memcmp(c.magia, BIN_MAGIA, 8) != 0 || c.version != 1) { error = "no es un archivo MATVEC01"; return false; }
+        if (c.tipo != 1) { error = "tipo de dato no admitido"; return false; }
+        if (c.filas < 0 || c.cols < 0 || c.ld < c.cols || c.desplazamiento % 64 != 0
+            || c.desplazamiento + (uint64_t)c.filas * c.ld * sizeof(double) > largo) {
+            error = "cabecera inconsistente con el tamaño del archivo";
+            return false;
+        }
+        return true;
+    }
+
+    bool crear(const string& ruta, int64_t filas, int64_t cols, int64_t ld, string& error) {
+        fd = open(ruta.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) { error = "no se pudo crear " + ruta + ": " + strerror(errno); return false; }
+        largo = BIN_ALINEACION + (size_t)filas * ld * sizeof(double);
+        if (ftruncate(fd, (off_t)largo) != 0) { error = string("ftruncate: ") + strerror(errno); return false; }
+        if (!mapear(PROT_READ | PROT_WRITE, error)) return false;
+        CabeceraBin c{};
+        memcpy(c.magia, BIN_MAGIA, 8);
+        c.version = 1;
+        c.tipo = 1;
+        c.filas = filas;
+        c.cols = cols;
+        c.ld = ld;
+        c.alineacion = BIN_ALINEACION;
+        c.desplazamiento = BIN_ALINEACION;
+        memcpy(mapa, &c, sizeof(c));
+        return true;
+    }
+
+    const CabeceraBin& cabecera() const { return *static_cast<const CabeceraBin*>(mapa); }
+    double* datos() const { return (double*)(static_cast<char*>(mapa) + cabecera().desplazamiento); }
+
+private:
+    bool mapear(int prot, string& error) {
+        void* p = mmap(nullptr, largo, prot, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) { error = string("mmap: ") + strerror(errno); return false; }
+        mapa = p;
+        return true;
+    }
+
+    void cerrar() {
+        if (mapa) munmap(mapa, largo);
+        if (fd >= 0) close(fd);
+        mapa = nullptr;
+        fd = -1;
+    }
+
+    int fd = -1;
+    void* mapa = nullptr;
+    size_t largo = 0;
+};
+
+// ===== Kernels de producto punto por fila =====
+// Cuatro acumuladores independientes para esconder la latencia del FMA (una
+// sola suma encadenada limita a una instrucción cada ~4 ciclos). Las versiones
+// SIMD se compilan con target(...) y se eligen en tiempo de ejecución según la
+// CPU, así un mismo binario sirve en toda la flota.
+using KernelFila = double (*)(const double* a, const double* x, int m);
+
+double dot_escalar(const double* a, const double* x, int m) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    int j = 0;
+    for (; j + 4 <= m; j += 4) {
+        s0 += a[j] * x[j];
+        s1 += a[j + 1] * x[j + 1];
+        s2 += a[j + 2] * x[j + 2];
+        s3 += a[j + 3] * x[j + 3];
+    }
+    for (; j < m; ++j) s0 += a[j] * x[j];
+    return (s0 + s1) + (s2 + s3);
+}
+
+__attribute__((target("sse2")))
+double dot_sse2(const double* a, const double* x, int m) {
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+    int j = 0;
+    for (; j + 8 <= m; j += 8) {
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_load_pd(a + j),     _mm_loadu_pd(x + j)));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_load_pd(a + j + 2), _mm_loadu_pd(x + j + 2)));
+        s2 = _mm_add_pd(s2, _mm_mul_pd(_mm_load_pd(a + j + 4), _mm_loadu_pd(x + j + 4)));
+        s3 = _mm_add_pd(s3, _mm_mul_pd(_mm_load_pd(a + j + 6), _mm_loadu_pd(x + j + 6)));
+    }
+    __m128d s = _mm_add_pd(_mm_add_pd(s0, s1), _mm_add_pd(s2, s3));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    for (; j < m; ++j) sum += a[j] * x[j];
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+double dot_avx2(const double* a, const double* x, int m) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    int j = 0;
+    for (; j + 16 <= m; j += 16) {
+        s0 = _mm256_fmadd_pd(_mm256_load_pd(a + j),      _mm256_loadu_pd(x + j),      s0);
+        s1 = _mm256_fmadd_pd(_mm256_load_pd(a + j + 4),  _mm256_loadu_pd(x + j + 4),  s1);
+        s2 = _mm256_fmadd_pd(_mm256_load_pd(a + j + 8),  _mm256_loadu_pd(x + j + 8),  s2);
+        s3 = _mm256_fmadd_pd(_mm256_load_pd(a + j + 12), _mm256_loadu_pd(x + j + 12), s3);
+    }
+    for (; j + 4 <= m; j += 4)
+        s0 = _mm256_fmadd_pd(_mm256_load_pd(a + j), _mm256_loadu_pd(x + j), s0);
+    __m256d s = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+    __m128d h = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+    for (; j < m; ++j) sum += a[j] * x[j];
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+double dot_avx512(const double* a, const double* x, int m) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    int j = 0;
+    for (; j + 32 <= m; j += 32) {
+        s0 = _mm512_fmadd_pd(_mm512_load_pd(a + j),      _mm512_loadu_pd(x + j),      s0);
+        s1 = _mm512_fmadd_pd(_mm512_load_pd(a + j + 8),  _mm512_loadu_pd(x + j + 8),  s1);
+        s2 = _mm512_fmadd_pd(_mm512_load_pd(a + j + 16), _mm512_loadu_pd(x + j + 16), s2);
+        s3 = _mm512_fmadd_pd(_mm512_load_pd(a + j + 24), _mm512_loadu_pd(x + j + 24), s3);
+    }
+    for (; j + 8 <= m; j += 8)
+        s0 = _mm512_fmadd_pd(_mm512_load_pd(a + j), _mm512_loadu_pd(x + j), s0);
+    if (j < m) {   // cola con máscara: el relleno de la fila no se lee
+        __mmask8 k = (__mmask8)((1u << (m - j)) - 1);
+        s1 = _mm512_fmadd_pd(_mm512_maskz_load_pd(k, a + j), _mm512_maskz_loadu_pd(k, x + j), s1);
+    }
+    alignas(64) double parcial[8];
+    _mm512_store_pd(parcial, _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+    return ((parcial[0] + parcial[1]) + (parcial[2] + parcial[3]))
+         + ((parcial[4] + parcial[5]) + (parcial[6] + parcial[7]));
+}
+
+struct InfoKernel { const char* nombre; KernelFila f; };
+
+// "auto" elige el más ancho que soporte la CPU (CPUID vía __builtin_cpu_supports).
+InfoKernel elegir_kernel(const string& pedido) {
+    __builtin_cpu_init();
+    bool avx512 = __builtin_cpu_supports("avx512f");
+    bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    bool sse2 = __builtin_cpu_supports("sse2");
+    if (pedido == "auto") {
+        if (avx512) return { "avx512", dot_avx512 };
+        if (avx2) return { "avx2", dot_avx2 };
+        if (sse2) return { "sse2", dot_sse2 };
+        return { "escalar", dot_escalar };
+    }
+    if (pedido == "escalar") return { "escalar", dot_escalar };
+    if (pedido == "sse2" && sse2) return { "sse2", dot_sse2 };
+    if (pedido == "avx2" && avx2) return { "avx2", dot_avx2 };
+    if (pedido == "avx512" && avx512) return { "avx512", dot_avx512 };
+    return { nullptr, nullptr };
+}
+
 // ===== Estructura de datos =====
 struct Task {
+    const MatrizDensa* A;
+    const double* x;
+    double* y;
+    int start_row;
+    int end_row;
+    KernelFila dot;
+};
+
+// Formato anterior (--anidada): cada fila es un bloque aparte en el heap.
+struct TaskAnidada {
     const vector<vector<double>>* A;
     const vector<double>* x;
     vector<double>* y;
@@ -28,6 +358,12 @@ struct Task {
 
 // ===== Función de cada hilo =====
 void worker(Task t) {
+    const int m = t.A->cols;
+    for (int i = t.start_row; i < t.end_row; ++i)
+        t.y[i] = t.dot(t.A->fila(i), t.x, m);
+}
+
+void worker_anidada(TaskAnidada t) {
     for (int i = t.start_row; i < t.end_row; ++i) {
         double sum = 0.0;
         for (size_t j = 0; j < t.x->size(); ++j)
@@ -36,10 +372,1473 @@ void worker(Task t) {
     }
 }
 
+// ===== Afinidad =====
+// Orden de CPUs para fijar hilos, leído de /sys. compacta: (socket, núcleo, cpu),
+// los hermanos SMT quedan juntos y se llena un socket antes de pasar al otro.
+// dispersa: (hermano SMT, núcleo, socket), primero un hilo por núcleo físico
+// alternando sockets. Solo se usan las CPUs permitidas al proceso.
+int leer_entero(const string& ruta, int por_defecto) {
+    ifstream f(ruta);
+    int v;
+    return (f >> v) ? v : por_defecto;
+}
+
+vector<int> orden_cpus(const string& politica) {
+    cpu_set_t permitidas;
+    CPU_ZERO(&permitidas);
+    sched_getaffinity(0, sizeof(permitidas), &permitidas);
+
+    struct Cpu { int cpu, socket, nucleo, smt; };
+    vector<Cpu> cpus;
+    for (int c = 0; c < CPU_SETSIZE; ++c) {
+        if (!CPU_ISSET(c, &permitidas)) continue;
+        string base = "/sys/devices/system/cpu/cpu" + to_string(c) + "/topology/";
+        cpus.push_back({ c, leer_entero(base + "physical_package_id", 0), leer_entero(base + "core_id", c), 0 });
+    }
+    // índice SMT: cuántas CPUs anteriores comparten (socket, núcleo)
+    for (size_t i = 0; i < cpus.size(); ++i)
+        for (size_t j = 0; j < i; ++j)
+            if (cpus[j].socket == cpus[i].socket && cpus[j].nucleo == cpus[i].nucleo) ++cpus[i].smt;
+
+    if (politica == "compacta")
+        sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b) {
+            return make_tuple(a.socket, a.nucleo, a.cpu) < make_tuple(b.socket, b.nucleo, b.cpu);
+        });
+    else
+        sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b) {
+            return make_tuple(a.smt, a.nucleo, a.socket) < make_tuple(b.smt, b.nucleo, b.socket);
+        });
+    vector<int> orden;
+    for (auto& c : cpus) orden.push_back(c.cpu);
+    return orden;
+}
+
+// Hilo id -> cpus[id % cpus.size()]; con cpus vacío no se fija nada.
+void fijar_hilo(thread& h, const vector<int>& cpus, int id) {
+    if (cpus.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[id % cpus.size()], &set);
+    int rc = pthread_setaffinity_np(h.native_handle(), sizeof(set), &set);
+    if (rc != 0) cerr << "pthread_setaffinity_np fallo para el hilo " << id << " (codigo " << rc << ")\n";
+}
+
+// ===== Pool de hilos persistente =====
+// Los hilos se crean una vez y duermen en una variable de condición (futex en
+// glibc) entre trabajos. ejecutar() publica un trabajo nuevo subiendo la
+// generación, cada hilo llama trabajo(id) y el último en terminar despierta
+// al llamador. Así una llamada cuesta dos despertares en vez de T creaciones.
+class PoolHilos {
+public:
+    explicit PoolHilos(int n, const vector<int>& cpus = {}) {
+        for (int id = 0; id < n; ++id) {
+            hilos.emplace_back(&PoolHilos::bucle, this, id);
+            fijar_hilo(hilos.back(), cpus, id);
+        }
+    }
+
+    ~PoolHilos() {
+        {
+            lock_guard<mutex> lk(m);
+            salir = true;
+        }
+        cv_trabajo.notify_all();
+        for (auto& h : hilos) h.join();
+    }
+
+    void ejecutar(const function<void(int)>& f) {
+        unique_lock<mutex> lk(m);
+        trabajo = &f;
+        pendientes = (int)hilos.size();
+        ++generacion;
+        cv_trabajo.notify_all();
+        cv_fin.wait(lk, [&] { return pendientes == 0; });
+        trabajo = nullptr;
+    }
+
+private:
+    void bucle(int id) {
+        uint64_t vista = 0;
+        for (;;) {
+            const function<void(int)>* f;
+            {
+                unique_lock<mutex> lk(m);
+                cv_trabajo.wait(lk, [&] { return salir || generacion != vista; });
+                if (salir) return;
+                vista = generacion;
+                f = trabajo;
+            }
+            (*f)(id);
+            lock_guard<mutex> lk(m);
+            if (--pendientes == 0) cv_fin.notify_one();
+        }
+    }
+
+    vector<thread> hilos;
+    mutex m;
+    condition_variable cv_trabajo, cv_fin;
+    const function<void(int)>* trabajo = nullptr;
+    uint64_t generacion = 0;
+    int pendientes = 0;
+    bool salir = false;
+};
+
+// Sin pool: un std::thread por hilo lógico en cada llamada.
+void ejecutar_con_hilos(int thread_count, const vector<int>& cpus, const function<void(int)>& f) {
+    vector<thread> threads;
+    for (int id = 0; id < thread_count; ++id) {
+        threads.emplace_back(f, id);
+        fijar_hilo(threads.back(), cpus, id);
+    }
+    for (auto& th : threads) th.join();
+}
+
+// ===== GEMM por bloques (--modo=gemm) =====
+// C = A·B al estilo BLIS: el bucle jc recorre paneles de NC columnas de B, pc
+// bloques de KC en la dimensión común y ic bloques de MC filas de A. El panel
+// de B (KC x NC) se empaqueta para que quepa en L3/L2 y el bloque de A (MC x KC)
+// para L2; cada micro-kernel recorre una tira de A (MR x KC) y una de B
+// (KC x NR) que viven en L1, acumulando el bloque MR x NR de C en registros.
+// Cada hilo toma su rango de filas igual que en matvec y empaqueta sus propios
+// paneles: se repite el empaquetado de B, pero no hace falta sincronizar.
+const int GEMM_KC = 256;
+const int GEMM_MC = 120;
+const int GEMM_NC = 2048;
+
+// c[MR x NR] += a_empaquetada (KC x MR) · b_empaquetada (KC x NR)
+// Los bucles de tamaño fijo van con '#pragma GCC unroll' para que los
+// acumuladores vivan en registros (GCC -O2 no los desenrolla solo).
+using MicroKernel = void (*)(int kc, const double* a, const double* b, double* c, size_t ldc);
+
+const int MICRO_MR_MAX = 8;
+const int MICRO_NR_MAX = 24;
+
+void micro_escalar(int kc, const double* a, const double* b, double* c, size_t ldc) {
+    double acc[4][4] = {};
+    for (int p = 0; p < kc; ++p, a += 4, b += 4)
+        #pragma GCC unroll 16
+        for (int r = 0; r < 4; ++r)
+            #pragma GCC unroll 16
+            for (int j = 0; j < 4; ++j)
+                acc[r][j] += a[r] * b[j];
+    #pragma GCC unroll 16
+    for (int r = 0; r < 4; ++r)
+        #pragma GCC unroll 16
+        for (int j = 0; j < 4; ++j)
+            c[r * ldc + j] += acc[r][j];
+}
+
+// 6 x 8: 12 acumuladores ymm + 2 de B + 1 difusión de A = 15 de 16 registros
+__attribute__((target("avx2,fma")))
+void micro_avx2(int kc, const double* a, const double* b, double* c, size_t ldc) {
+    __m256d acc[6][2];
+    #pragma GCC unroll 16
+    for (int r = 0; r < 6; ++r) acc[r][0] = acc[r][1] = _mm256_setzero_pd();
+    for (int p = 0; p < kc; ++p, a += 6, b += 8) {
+        __m256d b0 = _mm256_load_pd(b), b1 = _mm256_load_pd(b + 4);
+        #pragma GCC unroll 16
+        for (int r = 0; r < 6; ++r) {
+            __m256d ar = _mm256_broadcast_sd(a + r);
+            acc[r][0] = _mm256_fmadd_pd(ar, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_pd(ar, b1, acc[r][1]);
+        }
+    }
+    #pragma GCC unroll 16
+    for (int r = 0; r < 6; ++r) {
+        double* cr = c + r * ldc;
+        _mm256_storeu_pd(cr,     _mm256_add_pd(_mm256_loadu_pd(cr),     acc[r][0]));
+        _mm256_storeu_pd(cr + 4, _mm256_add_pd(_mm256_loadu_pd(cr + 4), acc[r][1]));
+    }
+}
+
+// 8 x 24: 24 acumuladores zmm + 3 de B + 1 difusión de A = 28 de 32 registros
+__attribute__((target("avx512f")))
+void micro_avx512(int kc, const double* a, const double* b, double* c, size_t ldc) {
+    __m512d acc[8][3];
+    #pragma GCC unroll 16
+    for (int r = 0; r < 8; ++r) acc[r][0] = acc[r][1] = acc[r][2] = _mm512_setzero_pd();
+    for (int p = 0; p < kc; ++p, a += 8, b += 24) {
+        __m512d b0 = _mm512_load_pd(b), b1 = _mm512_load_pd(b + 8), b2 = _mm512_load_pd(b + 16);
+        #pragma GCC unroll 16
+        for (int r = 0; r < 8; ++r) {
+            __m512d ar = _mm512_set1_pd(a[r]);
+            acc[r][0] = _mm512_fmadd_pd(ar, b0, acc[r][0]);
+            acc[r][1] = _mm512_fmadd_pd(ar, b1, acc[r][1]);
+            acc[r][2] = _mm512_fmadd_pd(ar, b2, acc[r][2]);
+        }
+    }
+    #pragma GCC unroll 16
+    for (int r = 0; r < 8; ++r) {
+        double* cr = c + r * ldc;
+        #pragma GCC unroll 16
+        for (int j = 0; j < 3; ++j)
+            _mm512_storeu_pd(cr + 8 * j, _mm512_add_pd(_mm512_loadu_pd(cr + 8 * j), acc[r][j]));
+    }
+}
+
+// Rendimiento pico: 12 cadenas de FMA independientes (latencia 4 x 2 puertos
+// necesita al menos 8 en vuelo). Devuelve un valor para que no se elimine.
+// Sin FMA (x86-64 base): GCC vectoriza micro_escalar con SSE2, así que su pico
+// es el de SSE2 con mul y add separados: 12 cadenas de cada una, 2 doubles.
+double pico_sse2(long iters) {
+    __m128d mul[12], suma[12];
+    const __m128d f = _mm_set1_pd(0.9999999), d = _mm_set1_pd(1e-9);
+    #pragma GCC unroll 16
+    for (int k = 0; k < 12; ++k) mul[k] = suma[k] = _mm_set1_pd(1.0 + k);
+    for (long it = 0; it < iters; ++it)
+        #pragma GCC unroll 16
+        for (int k = 0; k < 12; ++k) {
+            mul[k] = _mm_mul_pd(mul[k], f);
+            suma[k] = _mm_add_pd(suma[k], d);
+        }
+    alignas(16) double parcial[2];
+    __m128d s = _mm_setzero_pd();
+    #pragma GCC unroll 16
+    for (int k = 0; k < 12; ++k) s = _mm_add_pd(s, _mm_add_pd(mul[k], suma[k]));
+    _mm_store_pd(parcial, s);
+    return parcial[0] + parcial[1];
+}
+
+__attribute__((target("avx2,fma")))
+double pico_avx2(long iters) {
+    __m256d acc[12];
+    const __m256d f = _mm256_set1_pd(0.9999999), d = _mm256_set1_pd(1e-9);
+    #pragma GCC unroll 16
+    for (int k = 0; k < 12; ++k) acc[k] = _mm256_set1_pd(1.0 + k);
+    for (long it = 0; it < iters; ++it)
+        #pragma GCC unroll 16
+        for (int k = 0; k < 12; ++k) acc[k] = _mm256_fmadd_pd(acc[k], f, d);
+    alignas(32) double parcial[4];
+    __m256d s = acc[0];
+    #pragma GCC unroll 16
+    for (int k = 1; k < 12; ++k) s = _mm256_add_pd(s, acc[k]);
+    _mm256_store_pd(parcial, s);
+    return parcial[0] + parcial[1] + parcial[2] + parcial[3];
+}
+
+__attribute__((target("avx512f")))
+double pico_avx512(long iters) {
+    __m512d acc[12];
+    const __m512d f = _mm512_set1_pd(0.9999999), d = _mm512_set1_pd(1e-9);
+    #pragma GCC unroll 16
+    for (int k = 0; k < 12; ++k) acc[k] = _mm512_set1_pd(1.0 + k);
+    for (long it = 0; it < iters; ++it)
+        #pragma GCC unroll 16
+        for (int k = 0; k < 12; ++k) acc[k] = _mm512_fmadd_pd(acc[k], f, d);
+    alignas(64) double parcial[8];
+    __m512d s = acc[0];
+    #pragma GCC unroll 16
+    for (int k = 1; k < 12; ++k) s = _mm512_add_pd(s, acc[k]);
+    _mm512_store_pd(parcial, s);
+    double t = 0.0;
+    #pragma GCC unroll 16
+    for (int k = 0; k < 8; ++k) t += parcial[k];
+    return t;
+}
+
+struct InfoMicro {
+    const char* nombre;
+    int mr, nr;
+    int doubles_por_fma;   // ancho del vector (para el cálculo del pico)
+    MicroKernel f;
+    double (*pico)(long);
+};
+
+// Mismo criterio que elegir_kernel; SSE2 no tiene micro-kernel propio.
+InfoMicro elegir_micro(const string& kernel) {
+    if (kernel == "avx512") return { "avx512", 8, 24, 8, micro_avx512, pico_avx512 };
+    if (kernel == "avx2") return { "avx2", 6, 8, 4, micro_avx2, pico_avx2 };
+    return { "escalar", 4, 4, 2, micro_escalar, pico_sse2 };
+}
+
+// Pico medido: todos los hilos a la vez ejecutando solo FMA (incluye el efecto
+// de la bajada de frecuencia con muchos núcleos activos o con AVX-512).
+double medir_pico_gflops(const InfoMicro& mk, int thread_count) {
+    const long iters = 20000000 / mk.doubles_por_fma;
+    vector<thread> hilos;
+    vector<double> basura(thread_count);
+    auto t0 = high_resolution_clock::now();
+    for (int t = 0; t < thread_count; ++t)
+        hilos.emplace_back([&, t] { basura[t] = mk.pico(iters); });
+    for (auto& h : hilos) h.join();
+    double s = duration<double>(high_resolution_clock::now() - t0).count();
+    double flops = 2.0 * 12 * mk.doubles_por_fma * (double)iters * thread_count;
+    return flops / (s * 1e9);
+}
+
+// Tira de A: filas [i0, i0+mc) x columnas [p0, p0+kc), en bloques de MR filas
+// donde cada columna de la tira queda contigua. Filas de más se rellenan con 0.
+void empaquetar_A(const MatrizDensa& A, int i0, int mc, int p0, int kc, int mr, double* dst) {
+    for (int ir = 0; ir < mc; ir += mr)
+        for (int p = 0; p < kc; ++p)
+            for (int r = 0; r < mr; ++r)
+                *dst++ = ir + r < mc ? A.fila(i0 + ir + r)[p0 + p] : 0.0;
+}
+
+// Panel de B: filas [p0, p0+kc) x columnas [j0, j0+nc), en bloques de NR columnas.
+void empaquetar_B(const MatrizDensa& B, int p0, int kc, int j0, int nc, int nr, double* dst) {
+    for (int jr = 0; jr < nc; jr += nr)
+        for (int p = 0; p < kc; ++p) {
+            const double* b = B.fila(p0 + p) + j0 + jr;
+            for (int j = 0; j < nr; ++j)
+                *dst++ = jr + j < nc ? b[j] : 0.0;
+        }
+}
+
+struct TaskGemm {
+    const MatrizDensa* A;
+    const MatrizDensa* B;
+    MatrizDensa* C;
+    int start_row;
+    int end_row;
+    InfoMicro mk;
+};
+
+void worker_gemm(TaskGemm t) {
+    const int mr = t.mk.mr, nr = t.mk.nr;
+    const int k = t.A->cols, p_cols = t.B->cols;
+    const int MC = GEMM_MC / mr * mr, NC = GEMM_NC / nr * nr, KC = GEMM_KC;
+    VecAlineado Ap((size_t)MC * KC), Bp((size_t)KC * NC);
+    alignas(64) double borde[MICRO_MR_MAX * MICRO_NR_MAX];
+
+    for (int jc = 0; jc < p_cols; jc += NC) {
+        int nc = min(NC, p_cols - jc);
+        for (int pc = 0; pc < k; pc += KC) {
+            int kc = min(KC, k - pc);
+            empaquetar_B(*t.B, pc, kc, jc, nc, nr, Bp.data());
+            for (int ic = t.start_row; ic < t.end_row; ic += MC) {
+                int mc = min(MC, t.end_row - ic);
+                empaquetar_A(*t.A, ic, mc, pc, kc, mr, Ap.data());
+                for (int jr = 0; jr < nc; jr += nr) {
+                    const double* b = Bp.data() + (size_t)jr * kc;
+                    for (int ir = 0; ir < mc; ir += mr) {
+                        const double* a = Ap.data() + (size_t)ir * kc;
+                        double* c = t.C->fila(ic + ir) + jc + jr;
+                        int mrr = min(mr, mc - ir), nrr = min(nr, nc - jr);
+                        if (mrr == mr && nrr == nr) {
+                            t.mk.f(kc, a, b, c, t.C->ld);
+                        } else {
+                            // Bloque de borde: se calcula entero en un temporal
+                            // y solo se suma la parte que existe en C.
+                            fill(borde, borde + mr * nr, 0.0);
+                            t.mk.f(kc, a, b, borde, nr);
+                            for (int r = 0; r < mrr; ++r)
+                                for (int j = 0; j < nrr; ++j)
+                                    c[r * t.C->ld + j] += borde[r * nr + j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Referencia: triple bucle i-j-p tal cual (B se recorre por columnas).
+void worker_gemm_ingenuo(TaskGemm t) {
+    const int k = t.A->cols, p_cols = t.B->cols;
+    for (int i = t.start_row; i < t.end_row; ++i) {
+        const double* a = t.A->fila(i);
+        double* c = t.C->fila(i);
+        for (int j = 0; j < p_cols; ++j) {
+            double sum = 0.0;
+            for (int p = 0; p < k; ++p)
+                sum += a[p] * t.B->fila(p)[j];
+            c[j] = sum;
+        }
+    }
+}
+
+// Lanza un hilo por bloque de filas (mismo reparto que matvec) y devuelve ms.
+double ejecutar_gemm(void (*f)(TaskGemm), const MatrizDensa& A, const MatrizDensa& B,
+                     MatrizDensa& C, int thread_count, const InfoMicro& mk) {
+    vector<thread> threads;
+    int n = A.filas;
+    int rows_per_thread = n / thread_count;
+    int remainder = n % thread_count;
+
+    auto start = high_resolution_clock::now();
+    int current = 0;
+    for (int t = 0; t < thread_count; ++t) {
+        int start_row = current;
+        int end_row = start_row + rows_per_thread + (t < remainder ? 1 : 0);
+        current = end_row;
+        threads.emplace_back(f, TaskGemm{ &A, &B, &C, start_row, end_row, mk });
+    }
+    for (auto& th : threads) th.join();
+    return duration<double, milli>(high_resolution_clock::now() - start).count();
+}
+
+int main_gemm(int n, int m, int p, int thread_count, const InfoKernel& kernel, bool ingenuo) {
+    InfoMicro mk = elegir_micro(kernel.nombre);
+    cout << "GEMM: A " << n << "x" << m << " · B " << m << "x" << p
+         << ", Threads: " << thread_count
+         << ", Micro-kernel: " << mk.nombre << " " << mk.mr << "x" << mk.nr << "\n";
+    cout << "Bloques: MC=" << GEMM_MC / mk.mr * mk.mr << " KC=" << GEMM_KC
+         << " NC=" << GEMM_NC / mk.nr * mk.nr << "\n";
+
+    MatrizDensa A(n, m), B(m, p), C(n, p);
+    mt19937 gen(42);
+    uniform_real_distribution<double> dist(0.0, 1.0);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < m; ++j) A.fila(i)[j] = dist(gen);
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < p; ++j) B.fila(i)[j] = dist(gen);
+
+    double pico = medir_pico_gflops(mk, thread_count);
+    double flops = 2.0 * n * m * p;
+    cout << "Pico medido (" << (mk.f == micro_escalar ? string("SSE2 mul+add") : "FMA " + string(mk.nombre)) << ", " << thread_count << " hilos): "
+         << pico << " GFLOP/s\n";
+
+    double ms = ejecutar_gemm(worker_gemm, A, B, C, thread_count, mk);
+    double gf = flops / (ms * 1e6);
+    cout << "Bloqueado: " << ms / 1000.0 << " s, " << gf << " GFLOP/s ("
+         << 100.0 * gf / pico << "% del pico)\n";
+
+    if (ingenuo) {
+        MatrizDensa C_ref(n, p);
+        double ms_ref = ejecutar_gemm(worker_gemm_ingenuo, A, B, C_ref, thread_count, mk);
+        double gf_ref = flops / (ms_ref * 1e6);
+        double err = 0.0;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < p; ++j)
+                err = max(err, fabs(C.fila(i)[j] - C_ref.fila(i)[j]));
+        cout << "Ingenuo:   " << ms_ref / 1000.0 << " s, " << gf_ref << " GFLOP/s ("
+             << 100.0 * gf_ref / pico << "% del pico)\n";
+        cout << "Aceleración bloqueado/ingenuo: " << ms_ref / ms << "x\n";
+        cout << "Diferencia máxima |C - C_ingenuo|: " << err << "\n";
+    }
+
+    cout << "Primeros 5 valores de C (fila 0): ";
+    for (int j = 0; j < min(5, p); ++j) cout << C.fila(0)[j] << " ";
+    cout << "\n";
+    return 0;
+}
+
+// ===== Matrices dispersas (--modo=spmv) =====
+// CSR: ptr[i]..ptr[i+1] delimita las columnas/valores de la fila i.
+struct MatrizCSR {
+    int filas = 0, cols = 0;
+    vector<long> ptr;
+    vector<int> col;
+    VecAlineado val;
+
+    long nnz() const { return ptr.empty() ? 0 : ptr.back(); }
+    int largo(int i) const { return (int)(ptr[i + 1] - ptr[i]); }
+};
+
+// SELL-C-sigma con C = 8: las filas se ordenan por largo (de mayor a menor)
+// dentro de ventanas de sigma filas, se agrupan en trozos de C y cada trozo se
+// guarda por columnas con el ancho de su fila más larga, así los C elementos j
+// de un trozo son contiguos (una carga vectorial + un gather de x). Ordenar
+// reduce el relleno cuando el largo de las filas varía. ELLPACK es el caso
+// sigma = 1 con todos los trozos del ancho de la fila más larga.
+const int SELL_C = 8;
+
+struct MatrizSELL {
+    int filas = 0, cols = 0, sigma = 1;
+    vector<int> perm;            // perm[k*C + r] = fila real (-1 si es relleno)
+    vector<long> inicio;         // inicio[k] = desplazamiento del trozo k
+    vector<int> ancho;           // ancho[k] = largo de la fila más larga del trozo
+    vector<int, Alineado<int>> col;
+    VecAlineado val;
+
+    int trozos() const { return (int)ancho.size(); }
+    long almacenados() const { return inicio.empty() ? 0 : inicio.back(); }
+};
+
+MatrizSELL csr_a_sell(const MatrizCSR& A, int sigma, bool ell) {
+    MatrizSELL S;
+    S.filas = A.filas;
+    S.cols = A.cols;
+    S.sigma = ell ? 1 : sigma;
+    int n_trozos = (A.filas + SELL_C - 1) / SELL_C;
+
+    vector<int> orden(A.filas);
+    for (int i = 0; i < A.filas; ++i) orden[i] = i;
+    for (int v = 0; v < A.filas; v += S.sigma) {
+        auto fin = orden.begin() + min(A.filas, v + S.sigma);
+        stable_sort(orden.begin() + v, fin, [&](int a, int b) { return A.largo(a) > A.largo(b); });
+    }
+
+    int max_largo = 0;
+    for (int i = 0; i < A.filas; ++i) max_largo = max(max_largo, A.largo(i));
+
+    S.perm.assign((size_t)n_trozos * SELL_C, -1);
+    S.ancho.assign(n_trozos, 0);
+    S.inicio.assign(n_trozos + 1, 0);
+    for (int k = 0; k < n_trozos; ++k) {
+        for (int r = 0; r < SELL_C && k * SELL_C + r < A.filas; ++r) {
+            int fila = orden[k * SELL_C + r];
+            S.perm[k * SELL_C + r] = fila;
+            S.ancho[k] = max(S.ancho[k], A.largo(fila));
+        }
+        if (ell) S.ancho[k] = max_largo;
+        S.inicio[k + 1] = S.inicio[k] + (long)S.ancho[k] * SELL_C;
+    }
+
+    // Relleno: columna 0 y valor 0 (el gather lee x[0], que siempre existe).
+    S.col.assign(S.almacenados(), 0);
+    S.val.assign(S.almacenados(), 0.0);
+    for (int k = 0; k < n_trozos; ++k)
+        for (int r = 0; r < SELL_C; ++r) {
+            int fila = S.perm[k * SELL_C + r];
+            if (fila < 0) continue;
+            for (int j = 0; j < A.largo(fila); ++j) {
+                long d = S.inicio[k] + (long)j * SELL_C + r;
+                S.col[d] = A.col[A.ptr[fila] + j];
+                S.val[d] = A.val[A.ptr[fila] + j];
+            }
+        }
+    return S;
+}
+
+// Matriz aleatoria: se reparte densidad*n*m no ceros entre filas con peso
+// 1/(rango+1)^sesgo (rango al azar por fila), y cada fila elige sus columnas
+// uniformemente sin repetir.
+MatrizCSR generar_dispersa(int n, int m, double densidad, double sesgo, unsigned semilla) {
+    MatrizCSR A;
+    A.filas = n;
+    A.cols = m;
+    mt19937 gen(semilla);
+    uniform_real_distribution<double> dist(0.0, 1.0);
+
+    vector<int> rango(n);
+    for (int i = 0; i < n; ++i) rango[i] = i;
+    shuffle(rango.begin(), rango.end(), gen);
+    vector<double> peso(n);
+    double suma = 0.0;
+    for (int i = 0; i < n; ++i) suma += peso[i] = pow(rango[i] + 1.0, -sesgo);
+    double total = densidad * n * (double)m;
+
+    A.ptr.assign(n + 1, 0);
+    vector<int> cols_fila;
+    for (int i = 0; i < n; ++i) {
+        // parte entera + redondeo aleatorio de la fracción: el total esperado se mantiene
+        double esperado = total * peso[i] / suma;
+        int largo = (int)min<double>(m, floor(esperado) + (dist(gen) < esperado - floor(esperado)));
+        cols_fila.clear();
+        if (largo * 2 > m) {   // fila casi llena: muestreo por descarte
+            for (int j = 0; j < m; ++j)
+                if (dist(gen) * (m - j) < largo - (int)cols_fila.size()) cols_fila.push_back(j);
+        } else {
+            uniform_int_distribution<int> dcol(0, m - 1);
+            while ((int)cols_fila.size() < largo) {
+                cols_fila.push_back(dcol(gen));
+                if ((int)cols_fila.size() == largo) {
+                    sort(cols_fila.begin(), cols_fila.end());
+                    cols_fila.erase(unique(cols_fila.begin(), cols_fila.end()), cols_fila.end());
+                }
+            }
+        }
+        for (int c : cols_fila) {
+            A.col.push_back(c);
+            A.val.push_back(dist(gen));
+        }
+        A.ptr[i + 1] = (long)A.col.size();
+    }
+    return A;
+}
+
+// Matrix Market "coordinate" real | integer | pattern, general | symmetric.
+// Índices base 1; las entradas repetidas se suman.
+bool leer_mtx(const string& ruta, MatrizCSR& A, string& error) {
+    ifstream f(ruta);
+    if (!f) { error = "no se pudo abrir " + ruta; return false; }
+    string linea;
+    getline(f, linea);
+    string banner, objeto, formato, campo, simetria;
+    istringstream cab(linea);
+    cab >> banner >> objeto >> formato >> campo >> simetria;
+    for (auto* t : { &objeto, &formato, &campo, &simetria })
+        transform(t->begin(), t->end(), t->begin(), ::tolower);
+    if (banner != "%%MatrixMarket" || objeto != "matrix" || formato != "coordinate") {
+        error = "solo se admite %%MatrixMarket matrix coordinate";
+        return false;
+    }
+    bool patron = campo == "pattern";
+    if (!patron && campo != "real" && campo != "integer") { error = "campo no admitido: " + campo; return false; }
+    bool simetrica = simetria == "symmetric";
+    if (!simetrica && simetria != "general") { error = "simetría no admitida: " + simetria; return false; }
+
+    while (getline(f, linea) && (linea.empty() || linea[0] == '%')) {}
+    long n, m, entradas;
+    if (!(istringstream(linea) >> n >> m >> entradas)) { error = "línea de tamaño inválida"; return false; }
+
+    struct Elem { int i, j; double v; };
+    vector<Elem> coo;
+    coo.reserve(simetrica ? 2 * entradas : entradas);
+    for (long e = 0; e < entradas; ++e) {
+        long i, j;
+        double v = 1.0;
+        if (!(f >> i >> j) || (!patron && !(f >> v)) || i < 1 || i > n || j < 1 || j > m) {
+            error = "entrada " + to_string(e + 1) + " inválida";
+            return false;
+        }
+        coo.push_back({ (int)i - 1, (int)j - 1, v });
+        if (simetrica && i != j) coo.push_back({ (int)j - 1, (int)i - 1, v });
+    }
+    sort(coo.begin(), coo.end(), [](const Elem& a, const Elem& b) { return make_pair(a.i, a.j) < make_pair(b.i, b.j); });
+
+    A.filas = (int)n;
+    A.cols = (int)m;
+    A.ptr.assign(n + 1, 0);
+    A.col.clear();
+    A.val.clear();
+    for (size_t e = 0; e < coo.size(); ++e) {
+        if (e > 0 && coo[e].i == coo[e - 1].i && coo[e].j == coo[e - 1].j) {
+            A.val.back() += coo[e].v;
+            continue;
+        }
+        A.col.push_back(coo[e].j);
+        A.val.push_back(coo[e].v);
+        A.ptr[coo[e].i + 1] = (long)A.col.size();
+    }
+    for (long i = 1; i <= n; ++i) A.ptr[i] = max(A.ptr[i], A.ptr[i - 1]);   // filas vacías
+    return true;
+}
+
+// --- Kernels SpMV ---
+void spmv_csr(const MatrizCSR& A, const double* x, double* y, int fila_ini, int fila_fin) {
+    for (int i = fila_ini; i < fila_fin; ++i) {
+        double s = 0.0;
+        for (long k = A.ptr[i]; k < A.ptr[i + 1]; ++k) s += A.val[k] * x[A.col[k]];
+        y[i] = s;
+    }
+}
+
+// SELL sobre los trozos [k_ini, k_fin). Las filas de relleno (perm = -1) no se escriben.
+using KernelSell = void (*)(const MatrizSELL& S, const double* x, double* y, int k_ini, int k_fin);
+
+void sell_escalar(const MatrizSELL& S, const double* x, double* y, int k_ini, int k_fin) {
+    for (int k = k_ini; k < k_fin; ++k) {
+        double acc[SELL_C] = {};
+        const int* c = S.col.data() + S.inicio[k];
+        const double* v = S.val.data() + S.inicio[k];
+        for (int j = 0; j < S.ancho[k]; ++j, c += SELL_C, v += SELL_C)
+            for (int r = 0; r < SELL_C; ++r) acc[r] += v[r] * x[c[r]];
+        for (int r = 0; r < SELL_C; ++r)
+            if (S.perm[k * SELL_C + r] >= 0) y[S.perm[k * SELL_C + r]] = acc[r];
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void sell_avx2(const MatrizSELL& S, const double* x, double* y, int k_ini, int k_fin) {
+    for (int k = k_ini; k < k_fin; ++k) {
+        // gather con máscara completa y origen explícito (evita el aviso de
+        // GCC sobre el origen indefinido de la versión sin máscara)
+        const __m256d cero = _mm256_setzero_pd(), todos = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        __m256d a0 = cero, a1 = cero;
+        const int* c = S.col.data() + S.inicio[k];
+        const double* v = S.val.data() + S.inicio[k];
+        for (int j = 0; j < S.ancho[k]; ++j, c += SELL_C, v += SELL_C) {
+            __m256d x0 = _mm256_mask_i32gather_pd(cero, x, _mm_load_si128((const __m128i*)c), todos, 8);
+            __m256d x1 = _mm256_mask_i32gather_pd(cero, x, _mm_load_si128((const __m128i*)(c + 4)), todos, 8);
+            a0 = _mm256_fmadd_pd(_mm256_load_pd(v), x0, a0);
+            a1 = _mm256_fmadd_pd(_mm256_load_pd(v + 4), x1, a1);
+        }
+        alignas(32) double acc[SELL_C];
+        _mm256_store_pd(acc, a0);
+        _mm256_store_pd(acc + 4, a1);
+        for (int r = 0; r < SELL_C; ++r)
+            if (S.perm[k * SELL_C + r] >= 0) y[S.perm[k * SELL_C + r]] = acc[r];
+    }
+}
+
+__attribute__((target("avx512f")))
+void sell_avx512(const MatrizSELL& S, const double* x, double* y, int k_ini, int k_fin) {
+    for (int k = k_ini; k < k_fin; ++k) {
+        __m512d a = _mm512_setzero_pd();
+        const int* c = S.col.data() + S.inicio[k];
+        const double* v = S.val.data() + S.inicio[k];
+        for (int j = 0; j < S.ancho[k]; ++j, c += SELL_C, v += SELL_C) {
+            __m512d xv = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, _mm256_load_si256((const __m256i*)c), x, 8);
+            a = _mm512_fmadd_pd(_mm512_load_pd(v), xv, a);
+        }
+        alignas(64) double acc[SELL_C];
+        _mm512_store_pd(acc, a);
+        for (int r = 0; r < SELL_C; ++r)
+            if (S.perm[k * SELL_C + r] >= 0) y[S.perm[k * SELL_C + r]] = acc[r];
+    }
+}
+
+KernelSell elegir_sell(const string& kernel) {
+    if (kernel == "avx512") return sell_avx512;
+    if (kernel == "avx2") return sell_avx2;
+    return sell_escalar;
+}
+
+// Cortes [corte[t], corte[t+1]) por hilo sobre 'unidades' (filas en CSR,
+// trozos en SELL). Con peso acumulado (ptr o inicio), cada hilo recibe
+// ~total/T no ceros; sin él, el mismo reparto por filas que en el caso denso.
+vector<int> repartir(int unidades, const vector<long>* acumulado, int thread_count) {
+    vector<int> corte(thread_count + 1, unidades);
+    corte[0] = 0;
+    if (acumulado) {
+        long total = acumulado->back();
+        for (int t = 1; t < thread_count; ++t) {
+            long objetivo = total * t / thread_count;
+            corte[t] = (int)(lower_bound(acumulado->begin(), acumulado->end(), objetivo) - acumulado->begin());
+            corte[t] = max(corte[t - 1], min(corte[t], unidades));
+        }
+    } else {
+        int por_hilo = unidades / thread_count, resto = unidades % thread_count;
+        for (int t = 0; t < thread_count; ++t)
+            corte[t + 1] = corte[t] + por_hilo + (t < resto ? 1 : 0);
+    }
+    return corte;
+}
+
+struct OpcionesSpmv {
+    string formato = "csr", mtx, reparto = "nnz";
+    double densidad = 0.001, sesgo = 0.0;
+    int sigma = 256;
+    bool comparar_densa = false;
+};
+
+int main_spmv(int n, int m, int thread_count, const InfoKernel& kernel, int iteraciones,
+              const vector<int>& cpus, const OpcionesSpmv& op) {
+    MatrizCSR A;
+    auto t0 = high_resolution_clock::now();
+    if (!op.mtx.empty()) {
+        string error;
+        if (!leer_mtx(op.mtx, A, error)) {
+            cerr << "Error leyendo " << op.mtx << ": " << error << "\n";
+            return 1;
+        }
+    } else {
+        A = generar_dispersa(n, m, op.densidad, op.sesgo, 42);
+    }
+    double ms_carga = duration<double, milli>(high_resolution_clock::now() - t0).count();
+    n = A.filas;
+    m = A.cols;
+
+    bool sell = op.formato != "csr";
+    MatrizSELL S;
+    if (sell) S = csr_a_sell(A, op.sigma, op.formato == "ell");
+    KernelSell ksell = elegir_sell(kernel.nombre);
+    bool por_nnz = op.reparto == "nnz";
+
+    int min_largo = n ? A.largo(0) : 0, max_largo = 0;
+    for (int i = 0; i < n; ++i) {
+        min_largo = min(min_largo, A.largo(i));
+        max_largo = max(max_largo, A.largo(i));
+    }
+    cout << "SpMV: " << n << "x" << m << ", nnz: " << A.nnz()
+         << " (densidad " << (double)A.nnz() / ((double)n * m) << ")"
+         << ", Threads: " << thread_count << "\n";
+    cout << "Largo de filas: min " << min_largo << ", media " << (double)A.nnz() / max(n, 1)
+         << ", max " << max_largo << " (" << (op.mtx.empty() ? "generada" : "leída")
+         << " en " << ms_carga / 1000.0 << " s)\n";
+    cout << "Formato: " << op.formato;
+    if (sell)
+        cout << " (C=" << SELL_C << ", sigma=" << S.sigma << ", kernel " << (ksell == sell_escalar ? "escalar" : kernel.nombre)
+             << ", relleno " << 100.0 * (S.almacenados() - A.nnz()) / max(A.nnz(), 1L) << "%)";
+    cout << ", Reparto: " << op.reparto << "\n";
+
+    VecAlineado x(m), y(n);
+    mt19937 gen(7);
+    uniform_real_distribution<double> dist(0.0, 1.0);
+    for (int j = 0; j < m; ++j) x[j] = dist(gen);
+
+    vector<int> corte = sell ? repartir(S.trozos(), por_nnz ? &S.inicio : nullptr, thread_count)
+                             : repartir(n, por_nnz ? &A.ptr : nullptr, thread_count);
+    vector<double> ms_hilo(thread_count, 0.0);
+    vector<long> nnz_hilo(thread_count, 0);
+    for (int t = 0; t < thread_count; ++t)
+        nnz_hilo[t] = sell ? S.inicio[corte[t + 1]] - S.inicio[corte[t]] : A.ptr[corte[t + 1]] - A.ptr[corte[t]];
+
+    function<void(int)> trabajo = [&](int id) {
+        auto t0 = high_resolution_clock::now();
+        if (sell) ksell(S, x.data(), y.data(), corte[id], corte[id + 1]);
+        else spmv_csr(A, x.data(), y.data(), corte[id], corte[id + 1]);
+        ms_hilo[id] += duration<double, milli>(high_resolution_clock::now() - t0).count();
+    };
+
+    PoolHilos pool(thread_count, cpus);
+    auto start = high_resolution_clock::now();
+    for (int it = 0; it < iteraciones; ++it) pool.ejecutar(trabajo);
+    double time_ms = duration<double, milli>(high_resolution_clock::now() - start).count();
+
+    // Verificación contra CSR secuencial
+    VecAlineado y_ref(n);
+    spmv_csr(A, x.data(), y_ref.data(), 0, n);
+    double err = 0.0;
+    for (int i = 0; i < n; ++i) err = max(err, fabs(y[i] - y_ref[i]));
+
+    // val + col por no cero almacenado, ptr (o metadatos de trozos), x e y
+    double guardados = sell ? (double)S.almacenados() : (double)A.nnz();
+    double bytes = (12.0 * guardados + 8.0 * (n + 1) + 8.0 * (m + n)) * iteraciones;
+    cout << "Tiempo total: " << time_ms / 1000.0 << " s";
+    if (iteraciones > 1) cout << " (" << time_ms / iteraciones << " ms por llamada)";
+    cout << "\n";
+    cout << "Rendimiento: " << 2.0 * A.nnz() * iteraciones / (time_ms * 1e6) << " GFLOP/s\n";
+    cout << "Ancho de banda efectivo: " << bytes / (time_ms * 1e6) << " GB/s\n";
+    double ms_max = 0.0, ms_suma = 0.0;
+    cout << "Tiempo por hilo (ms, nnz):";
+    for (int t = 0; t < thread_count; ++t) {
+        cout << " h" << t << "=" << ms_hilo[t] << " (" << nnz_hilo[t] << ")";
+        ms_max = max(ms_max, ms_hilo[t]);
+        ms_suma += ms_hilo[t];
+    }
+    cout << "\nDesbalance (max/media): " << ms_max / (ms_suma / thread_count) << "\n";
+    cout << "Diferencia máxima con CSR secuencial: " << err << "\n";
+
+    if (op.comparar_densa) {
+        double bytes_densa = 8.0 * n * (double)m;
+        if (bytes_densa > 4e9) {
+            cout << "Densa: omitida (" << bytes_densa / 1e9 << " GB)\n";
+        } else {
+            MatrizDensa D(n, m);
+            for (int i = 0; i < n; ++i)
+                for (long k = A.ptr[i]; k < A.ptr[i + 1]; ++k) D.fila(i)[A.col[k]] = A.val[k];
+            vector<int> filas_d = repartir(n, nullptr, thread_count);
+            function<void(int)> densa = [&](int id) {
+                worker(Task{ &D, x.data(), y.data(), filas_d[id], filas_d[id + 1], kernel.f });
+            };
+            auto sd = high_resolution_clock::now();
+            for (int it = 0; it < iteraciones; ++it) pool.ejecutar(densa);
+            double ms_d = duration<double, milli>(high_resolution_clock::now() - sd).count();
+            cout << "Densa (" << kernel.nombre << "): " << ms_d / 1000.0 << " s, "
+                 << "aceleración dispersa/densa: " << ms_d / time_ms << "x\n";
+        }
+    }
+
+    cout << "Primeros 5 valores de y: ";
+    for (int i = 0; i < min(5, n); ++i) cout << y_ref[i] << " ";
+    cout << "\n";
+    return 0;
+}
+
+// ===== Matvec fuera de memoria (--stream) =====
+// Un hilo lector trae paneles de filas del archivo binario con pread a uno de
+// dos buffers mientras el pool calcula sobre el otro, así la E/S del panel p+1
+// se solapa con el cálculo del panel p. Solo dos paneles viven en memoria; tras
+// usar cada panel se avisa al kernel (POSIX_FADV_DONTNEED) que puede soltar
+// esas páginas de la caché, para no desplazar al resto del sistema.
+int main_stream(const string& ruta, int thread_count, const InfoKernel& kernel, int iteraciones,
+                int panel_filas, const vector<int>& cpus) {
+    int fd = open(ruta.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Error abriendo " << ruta << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    CabeceraBin cab;
+    if (pread(fd, &cab, sizeof(cab), 0) != (ssize_t)sizeof(cab) || memcmp(cab.magia, BIN_MAGIA, 8) != 0
+        || cab.version != 1 || cab.tipo != 1 || cab.ld < cab.cols || cab.ld % 8 != 0) {
+        cerr << "Error: " << ruta << " no es un archivo MATVEC01 válido\n";
+        close(fd);
+        return 1;
+    }
+    const int n = (int)cab.filas, m = (int)cab.cols;
+    const size_t bytes_fila = (size_t)cab.ld * sizeof(double);
+    if (panel_filas <= 0) panel_filas = (int)max<size_t>(1, (32u << 20) / bytes_fila);
+    panel_filas = max(1, min(panel_filas, max(n, 1)));
+    const int n_paneles = (n + panel_filas - 1) / panel_filas;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    cout << "Stream: " << ruta << ", Matriz: " << n << "x" << m << ", Threads: " << thread_count
+         << ", Kernel: " << kernel.nombre << "\n";
+    cout << "Panel: " << panel_filas << " filas (" << panel_filas * bytes_fila / 1e6 << " MB), "
+         << n_paneles << " paneles, 2 buffers\n";
+
+    VecAlineado x(m), y(n);
+    mt19937 gen(7);   // misma x que --bin
+    uniform_real_distribution<double> dist(0.0, 1.0);
+    for (int j = 0; j < m; ++j) x[j] = dist(gen);
+
+    VecAlineado buf[2] = { VecAlineado((size_t)panel_filas * cab.ld), VecAlineado((size_t)panel_filas * cab.ld) };
+    mutex mx;
+    condition_variable cv;
+    bool lleno[2] = { false, false };
+    bool error_lectura = false;
+    const long total_paneles = (long)n_paneles * iteraciones;
+
+    // Tiempos: el lector acumula lo que pasa dentro de pread y lo que espera un
+    // buffer libre; el lado de cálculo, lo que tarda el pool y lo que espera datos.
+    double ms_io = 0.0, ms_lector_espera = 0.0, ms_calculo = 0.0, ms_calculo_espera = 0.0;
+
+    auto inicio = high_resolution_clock::now();
+    thread lector([&] {
+        for (long q = 0; q < total_paneles; ++q) {
+            int b = (int)(q % 2), p = (int)(q % n_paneles);
+            auto t0 = high_resolution_clock::now();
+            {
+                unique_lock<mutex> lk(mx);
+                cv.wait(lk, [&] { return !lleno[b] || error_lectura; });
+                if (error_lectura) return;
+            }
+            auto t1 = high_resolution_clock::now();
+            int filas = min(panel_filas, n - p * panel_filas);
+            size_t pedir = (size_t)filas * bytes_fila, leidos = 0;
+            off_t off = (off_t)(cab.desplazamiento + (uint64_t)p * panel_filas * bytes_fila);
+            char* dst = (char*)buf[b].data();
+            while (leidos < pedir) {
+                ssize_t r = pread(fd, dst + leidos, pedir - leidos, off + (off_t)leidos);
+                if (r <= 0) break;
+                leidos += (size_t)r;
+            }
+            auto t2 = high_resolution_clock::now();
+            lock_guard<mutex> lk(mx);
+            ms_lector_espera += duration<double, milli>(t1 - t0).count();
+            ms_io += duration<double, milli>(t2 - t1).count();
+            if (leidos < pedir) error_lectura = true;
+            lleno[b] = true;
+            cv.notify_all();
+            if (error_lectura) return;
+        }
+    });
+
+    PoolHilos pool(thread_count, cpus);
+    for (long q = 0; q < total_paneles; ++q) {
+        int b = (int)(q % 2), p = (int)(q % n_paneles);
+        auto t0 = high_resolution_clock::now();
+        {
+            unique_lock<mutex> lk(mx);
+            cv.wait(lk, [&] { return lleno[b] || error_lectura; });
+            if (error_lectura) break;
+        }
+        auto t1 = high_resolution_clock::now();
+
+        int fila0 = p * panel_filas;
+        int filas = min(panel_filas, n - fila0);
+        MatrizDensa panel(filas, m, (size_t)cab.ld, buf[b].data());
+        vector<int> corte = repartir(filas, nullptr, thread_count);
+        pool.ejecutar([&](int id) {
+            worker(Task{ &panel, x.data(), y.data() + fila0, corte[id], corte[id + 1], kernel.f });
+        });
+        posix_fadvise(fd, (off_t)(cab.desplazamiento + (uint64_t)fila0 * bytes_fila),
+                      (off_t)((size_t)filas * bytes_fila), POSIX_FADV_DONTNEED);
+
+        auto t2 = high_resolution_clock::now();
+        ms_calculo_espera += duration<double, milli>(t1 - t0).count();
+        ms_calculo += duration<double, milli>(t2 - t1).count();
+        lock_guard<mutex> lk(mx);
+        lleno[b] = false;
+        cv.notify_all();
+    }
+    lector.join();
+    close(fd);
+    double ms_total = duration<double, milli>(high_resolution_clock::now() - inicio).count();
+
+    if (error_lectura) {
+        cerr << "Error: lectura corta en " << ruta << "\n";
+        return 1;
+    }
+
+    // Solapamiento: fracción del recurso menos ocupado que quedó escondida
+    // detrás del otro (1 = perfecto, 0 = todo en serie).
+    double bytes = (double)n * bytes_fila * iteraciones;
+    double solape = (ms_io + ms_calculo - ms_total) / max(1e-9, min(ms_io, ms_calculo));
+    cout << "Tiempo total: " << ms_total / 1000.0 << " s";
+    if (iteraciones > 1) cout << " (" << iteraciones << " pasadas)";
+    cout << "\n";
+    cout << "E/S: " << ms_io / 1000.0 << " s (" << bytes / (ms_io * 1e6) << " GB/s), lector esperando buffer: "
+         << ms_lector_espera / 1000.0 << " s\n";
+    cout << "Cálculo: " << ms_calculo / 1000.0 << " s (" << bytes / (ms_calculo * 1e6) << " GB/s), esperando datos: "
+         << ms_calculo_espera / 1000.0 << " s\n";
+    cout << "Solapamiento E/S-cálculo: " << 100.0 * max(0.0, min(1.0, solape)) << "%, "
+         << (ms_io > ms_calculo ? "limitado por disco" : "limitado por CPU") << "\n";
+    cout << "Rendimiento: " << 2.0 * n * m * iteraciones / (ms_total * 1e6) << " GFLOP/s\n";
+    cout << "Primeros 5 valores de y: ";
+    for (int i = 0; i < min(5, n); ++i) cout << y[i] << " ";
+    cout << "\n";
+    return 0;
+}
+
+// ===== Precisión reducida (--precision) =====
+// El kernel es limitado por ancho de banda: guardar A en float (4 B) o bf16
+// (2 B) reduce el tráfico a la mitad o a un cuarto. 'mixta' lee A en float pero
+// acumula en double: el error queda en el redondeo de A (que en buena parte se
+// cancela en la suma) y no crece con m como al acumular en float.
+
+// bfloat16: los 16 bits altos de un float (mismo exponente, 7 bits de mantisa).
+struct bf16 { uint16_t bits; };
+
+inline float valor(float v) { return v; }
+inline double valor(double v) { return v; }
+inline float valor(bf16 v) {
+    uint32_t u = (uint32_t)v.bits << 16;
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// Redondeo al par más cercano (NaN no aparece: A sale de [0, 1)).
+inline bf16 a_bf16(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    u += 0x7FFF + ((u >> 16) & 1);
+    return bf16{ (uint16_t)(u >> 16) };
+}
+
+// T: tipo de A, X: tipo de x, R: tipo del acumulador y de y.
+template <class T, class X, class R>
+R dot_escalar_t(const T* a, const X* x, int m) {
+    R s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int j = 0;
+    for (; j + 4 <= m; j += 4) {
+        s0 += (R)valor(a[j]) * (R)x[j];
+        s1 += (R)valor(a[j + 1]) * (R)x[j + 1];
+        s2 += (R)valor(a[j + 2]) * (R)x[j + 2];
+        s3 += (R)valor(a[j + 3]) * (R)x[j + 3];
+    }
+    for (; j < m; ++j) s0 += (R)valor(a[j]) * (R)x[j];
+    return (s0 + s1) + (s2 + s3);
+}
+
+__attribute__((target("avx2,fma")))
+float suma_ps256(__m256 v) {
+    alignas(32) float p[8];
+    _mm256_store_ps(p, v);
+    return ((p[0] + p[1]) + (p[2] + p[3])) + ((p[4] + p[5]) + (p[6] + p[7]));
+}
+
+__attribute__((target("avx2,fma")))
+double suma_pd256(__m256d v) {
+    alignas(32) double p[4];
+    _mm256_store_pd(p, v);
+    return (p[0] + p[1]) + (p[2] + p[3]);
+}
+
+__attribute__((target("avx512f")))
+float suma_ps512(__m512 v) {
+    alignas(64) float p[16];
+    _mm512_store_ps(p, v);
+    float s = 0.0f;
+    for (int k = 0; k < 16; ++k) s += p[k];
+    return s;
+}
+
+__attribute__((target("avx512f")))
+double suma_pd512(__m512d v) {
+    alignas(64) double p[8];
+    _mm512_store_pd(p, v);
+    return ((p[0] + p[1]) + (p[2] + p[3])) + ((p[4] + p[5]) + (p[6] + p[7]));
+}
+
+// --- float ---
+__attribute__((target("avx2,fma")))
+float dot_f32_avx2(const float* a, const float* x, int m) {
+    __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+    int j = 0;
+    for (; j + 32 <= m; j += 32) {
+        s0 = _mm256_fmadd_ps(_mm256_load_ps(a + j),      _mm256_loadu_ps(x + j),      s0);
+        s1 = _mm256_fmadd_ps(_mm256_load_ps(a + j + 8),  _mm256_loadu_ps(x + j + 8),  s1);
+        s2 = _mm256_fmadd_ps(_mm256_load_ps(a + j + 16), _mm256_loadu_ps(x + j + 16), s2);
+        s3 = _mm256_fmadd_ps(_mm256_load_ps(a + j + 24), _mm256_loadu_ps(x + j + 24), s3);
+    }
+    for (; j + 8 <= m; j += 8)
+        s0 = _mm256_fmadd_ps(_mm256_load_ps(a + j), _mm256_loadu_ps(x + j), s0);
+    float sum = suma_ps256(_mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+    for (; j < m; ++j) sum += a[j] * x[j];
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+float dot_f32_avx512(const float* a, const float* x, int m) {
+    __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps(), s2 = _mm512_setzero_ps(), s3 = _mm512_setzero_ps();
+    int j = 0;
+    for (; j + 64 <= m; j += 64) {
+        s0 = _mm512_fmadd_ps(_mm512_load_ps(a + j),      _mm512_loadu_ps(x + j),      s0);
+        s1 = _mm512_fmadd_ps(_mm512_load_ps(a + j + 16), _mm512_loadu_ps(x + j + 16), s1);
+        s2 = _mm512_fmadd_ps(_mm512_load_ps(a + j + 32), _mm512_loadu_ps(x + j + 32), s2);
+        s3 = _mm512_fmadd_ps(_mm512_load_ps(a + j + 48), _mm512_loadu_ps(x + j + 48), s3);
+    }
+    for (; j + 16 <= m; j += 16)
+        s0 = _mm512_fmadd_ps(_mm512_load_ps(a + j), _mm512_loadu_ps(x + j), s0);
+    if (j < m) {   // cola con máscara, igual que dot_avx512
+        __mmask16 k = (__mmask16)((1u << (m - j)) - 1);
+        s1 = _mm512_fmadd_ps(_mm512_maskz_load_ps(k, a + j), _mm512_maskz_loadu_ps(k, x + j), s1);
+    }
+    return suma_ps512(_mm512_add_ps(_mm512_add_ps(s0, s1), _mm512_add_ps(s2, s3)));
+}
+
+// --- mixta: A en float, x y acumulación en double ---
+__attribute__((target("avx2,fma")))
+double dot_mixta_avx2(const float* a, const double* x, int m) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    int j = 0;
+    for (; j + 16 <= m; j += 16) {
+        __m256 a0 = _mm256_load_ps(a + j), a1 = _mm256_load_ps(a + j + 8);
+        s0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(a0)),   _mm256_loadu_pd(x + j),      s0);
+        s1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(a0, 1)), _mm256_loadu_pd(x + j + 4),  s1);
+        s2 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(a1)),   _mm256_loadu_pd(x + j + 8),  s2);
+        s3 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(a1, 1)), _mm256_loadu_pd(x + j + 12), s3);
+    }
+    double sum = suma_pd256(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    for (; j < m; ++j) sum += (double)a[j] * x[j];
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+double dot_mixta_avx512(const float* a, const double* x, int m) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    int j = 0;
+    // Versiones maskz con máscara completa: las sin máscara usan un origen
+    // indefinido que GCC 12 reporta como posible uso sin inicializar.
+    const __mmask8 todo = 0xFF;
+    for (; j + 32 <= m; j += 32) {
+        s0 = _mm512_fmadd_pd(_mm512_maskz_cvtps_pd(todo, _mm256_load_ps(a + j)),      _mm512_loadu_pd(x + j),      s0);
+        s1 = _mm512_fmadd_pd(_mm512_maskz_cvtps_pd(todo, _mm256_load_ps(a + j + 8)),  _mm512_loadu_pd(x + j + 8),  s1);
+        s2 = _mm512_fmadd_pd(_mm512_maskz_cvtps_pd(todo, _mm256_load_ps(a + j + 16)), _mm512_loadu_pd(x + j + 16), s2);
+        s3 = _mm512_fmadd_pd(_mm512_maskz_cvtps_pd(todo, _mm256_load_ps(a + j + 24)), _mm512_loadu_pd(x + j + 24), s3);
+    }
+    double sum = suma_pd512(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+    for (; j < m; ++j) sum += (double)a[j] * x[j];
+    return sum;
+}
+
+// --- bf16: A en bfloat16, x y acumulación en float ---
+// Pasar de bf16 a float es ensanchar a 32 bits y desplazar 16 a la izquierda.
+__attribute__((target("avx2,fma")))
+float dot_bf16_avx2(const bf16* a, const float* x, int m) {
+    __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+    int j = 0;
+    for (; j + 16 <= m; j += 16) {
+        __m256i b = _mm256_load_si256((const __m256i*)(a + j));
+        __m256 a0 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(b)), 16));
+        __m256 a1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(b, 1)), 16));
+        s0 = _mm256_fmadd_ps(a0, _mm256_loadu_ps(x + j),     s0);
+        s1 = _mm256_fmadd_ps(a1, _mm256_loadu_ps(x + j + 8), s1);
+    }
+    float sum = suma_ps256(_mm256_add_ps(s0, s1));
+    for (; j < m; ++j) sum += valor(a[j]) * x[j];
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+float dot_bf16_avx512(const bf16* a, const float* x, int m) {
+    __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+    int j = 0;
+    const __mmask16 todo = 0xFFFF;   // maskz por el mismo motivo que en dot_mixta_avx512
+    for (; j + 32 <= m; j += 32) {
+        __m512i b0 = _mm512_maskz_cvtepu16_epi32(todo, _mm256_load_si256((const __m256i*)(a + j)));
+        __m512i b1 = _mm512_maskz_cvtepu16_epi32(todo, _mm256_load_si256((const __m256i*)(a + j + 16)));
+        s0 = _mm512_fmadd_ps(_mm512_castsi512_ps(_mm512_maskz_slli_epi32(todo, b0, 16)), _mm512_loadu_ps(x + j),      s0);
+        s1 = _mm512_fmadd_ps(_mm512_castsi512_ps(_mm512_maskz_slli_epi32(todo, b1, 16)), _mm512_loadu_ps(x + j + 16), s1);
+    }
+    float sum = suma_ps512(_mm512_add_ps(s0, s1));
+    for (; j < m; ++j) sum += valor(a[j]) * x[j];
+    return sum;
+}
+
+// Mismo nombre de kernel que elegir_kernel; sse2 usa la versión escalar.
+template <class T, class X, class R>
+struct InfoKernelT { const char* nombre; R (*f)(const T*, const X*, int); };
+
+InfoKernelT<float, float, float> elegir_f32(const string& k) {
+    if (k == "avx512") return { "avx512", dot_f32_avx512 };
+    if (k == "avx2") return { "avx2", dot_f32_avx2 };
+    return { "escalar", dot_escalar_t<float, float, float> };
+}
+
+InfoKernelT<float, double, double> elegir_mixta(const string& k) {
+    if (k == "avx512") return { "avx512", dot_mixta_avx512 };
+    if (k == "avx2") return { "avx2", dot_mixta_avx2 };
+    return { "escalar", dot_escalar_t<float, double, double> };
+}
+
+InfoKernelT<bf16, float, float> elegir_bf16(const string& k) {
+    if (k == "avx512") return { "avx512", dot_bf16_avx512 };
+    if (k == "avx2") return { "avx2", dot_bf16_avx2 };
+    return { "escalar", dot_escalar_t<bf16, float, float> };
+}
+
+// Convierte A y x (generadas en double) a los tipos de almacenamiento, mide la
+// multiplicación y compara y con la referencia en double.
+template <class T, class X, class R, class Conv>
+void medir_precision(const MatrizDensa& A, const VecAlineado& x, const VecAlineado& y_ref,
+                     InfoKernelT<T, X, R> k, Conv convertir, PoolHilos& pool, int thread_count,
+                     int iteraciones, const char* nombre) {
+    const int n = A.filas, m = A.cols;
+    MatrizDensaT<T> Ab(n, m);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < m; ++j) Ab.fila(i)[j] = convertir(A.fila(i)[j]);
+    vector<X, Alineado<X>> xb(m);
+    for (int j = 0; j < m; ++j) xb[j] = (X)x[j];
+    vector<R, Alineado<R>> yb(n);
+
+    vector<int> corte = repartir(n, nullptr, thread_count);
+    auto start = high_resolution_clock::now();
+    for (int it = 0; it < iteraciones; ++it)
+        pool.ejecutar([&](int id) {
+            for (int i = corte[id]; i < corte[id + 1]; ++i) yb[i] = k.f(Ab.fila(i), xb.data(), m);
+        });
+    double ms = duration<double, milli>(high_resolution_clock::now() - start).count();
+
+    double err_max = 0.0, err_suma = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double e = fabs((double)yb[i] - y_ref[i]) / max(fabs(y_ref[i]), 1e-300);
+        err_max = max(err_max, e);
+        err_suma += e;
+    }
+    double bytes = ((double)n * m * sizeof(T) + (double)m * sizeof(X) + (double)n * sizeof(R)) * iteraciones;
+    cout << nombre << " (kernel " << k.nombre << ", A " << sizeof(T) << " B/elem): "
+         << ms / iteraciones << " ms/llamada, " << 2.0 * n * m * iteraciones / (ms * 1e6) << " GFLOP/s, "
+         << bytes / (ms * 1e6) << " GB/s, error relativo max " << err_max
+         << " medio " << err_suma / max(n, 1) << "\n";
+}
+
+int main_precision(int n, int m, int thread_count, const InfoKernel& kernel, int iteraciones,
+                   const vector<int>& cpus, const string& precision) {
+    cout << "Matriz: " << n << "x" << m << ", Threads: " << thread_count
+         << ", Precisión: " << precision << ", Kernel: " << kernel.nombre << "\n";
+
+    // Mismos valores que el modo normal (A y luego x desde la semilla 42)
+    MatrizDensa A(n, m);
+    VecAlineado x(m), y_ref(n);
+    mt19937 gen(42);
+    uniform_real_distribution<double> dist(0.0, 1.0);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < m; ++j) A.fila(i)[j] = dist(gen);
+    for (int j = 0; j < m; ++j) x[j] = dist(gen);
+
+    PoolHilos pool(thread_count, cpus);
+    vector<int> corte = repartir(n, nullptr, thread_count);
+    auto start = high_resolution_clock::now();
+    for (int it = 0; it < iteraciones; ++it)
+        pool.ejecutar([&](int id) {
+            worker(Task{ &A, x.data(), y_ref.data(), corte[id], corte[id + 1], kernel.f });
+        });
+    double ms = duration<double, milli>(high_resolution_clock::now() - start).count();
+    cout << "double (referencia, kernel " << kernel.nombre << "): " << ms / iteraciones << " ms/llamada, "
+         << 2.0 * n * m * iteraciones / (ms * 1e6) << " GFLOP/s, "
+         << 8.0 * ((double)n * m + m + n) * iteraciones / (ms * 1e6) << " GB/s\n";
+
+    auto a_float = [](double v) { return (float)v; };
+    if (precision == "float")
+        medir_precision(A, x, y_ref, elegir_f32(kernel.nombre), a_float, pool, thread_count, iteraciones, "float");
+    else if (precision == "mixta")
+        medir_precision(A, x, y_ref, elegir_mixta(kernel.nombre), a_float, pool, thread_count, iteraciones, "mixta");
+    else
+        medir_precision(A, x, y_ref, elegir_bf16(kernel.nombre), [](double v) { return a_bf16((float)v); },
+                        pool, thread_count, iteraciones, "bf16");
+
+    cout << "Primeros 5 valores de y (double): ";
+    for (int i = 0; i < min(5, n); ++i) cout << y_ref[i] << " ";
+    cout << "\n";
+    return 0;
+}
+
+// ===== Varios vectores por pasada (--rhs) =====
+// Y = A·X con X de k columnas. X e Y se guardan intercaladas: X[j*kp + c] es el
+// elemento j del vector c, así los k valores que multiplican a A[i][j] son
+// contiguos y caben en uno o varios registros. Cada A[i][j] se lee una vez y
+// se usa k veces: con k grande el kernel deja de estar limitado por memoria.
+// kp es k redondeado a múltiplo de 8 (las columnas de relleno valen 0).
+//
+// Bloque de registros: NR filas de A x NB vectores SIMD de columnas de X;
+// por cada j se difunden NR valores de A y se cargan NB de X. Las columnas de
+// A se recorren en tramos [j0, j1) para que el tramo de X (j1-j0 filas de kp
+// doubles) quede en L2 mientras pasan todas las filas del hilo; el primer
+// tramo escribe Y y los siguientes acumulan. Los bucles sobre r y b llevan
+// '#pragma GCC unroll': sin desenrollar, GCC -O2 deja acc[][] en la pila.
+template <int NR, int NB>
+__attribute__((target("avx512f")))
+void bloque_rhs_avx512(const double* const* a, int j0, int j1, const double* X, double* const* y, size_t kp, int c0) {
+    __m512d acc[NR][NB];
+    #pragma GCC unroll 16
+    for (int r = 0; r < NR; ++r)
+        #pragma GCC unroll 16
+        for (int b = 0; b < NB; ++b) acc[r][b] = j0 == 0 ? _mm512_setzero_pd() : _mm512_load_pd(y[r] + c0 + 8 * b);
+    for (int j = j0; j < j1; ++j) {
+        const double* xj = X + (size_t)j * kp + c0;
+        __m512d xv[NB];
+        #pragma GCC unroll 16
+        for (int b = 0; b < NB; ++b) xv[b] = _mm512_load_pd(xj + 8 * b);
+        #pragma GCC unroll 16
+        for (int r = 0; r < NR; ++r) {
+            __m512d ar = _mm512_set1_pd(a[r][j]);
+            #pragma GCC unroll 16
+            for (int b = 0; b < NB; ++b) acc[r][b] = _mm512_fmadd_pd(ar, xv[b], acc[r][b]);
+        }
+    }
+    #pragma GCC unroll 16
+    for (int r = 0; r < NR; ++r)
+        #pragma GCC unroll 16
+        for (int b = 0; b < NB; ++b) _mm512_store_pd(y[r] + c0 + 8 * b, acc[r][b]);
+}
+
+template <int NR, int NB>
+__attribute__((target("avx2,fma")))
+void bloque_rhs_avx2(const double* const* a, int j0, int j1, const double* X, double* const* y, size_t kp, int c0) {
+    __m256d acc[NR][NB];
+    #pragma GCC unroll 16
+    for (int r = 0; r < NR; ++r)
+        #pragma GCC unroll 16
+        for (int b = 0; b < NB; ++b) acc[r][b] = j0 == 0 ? _mm256_setzero_pd() : _mm256_load_pd(y[r] + c0 + 4 * b);
+    for (int j = j0; j < j1; ++j) {
+        const double* xj = X + (size_t)j * kp + c0;
+        __m256d xv[NB];
+        #pragma GCC unroll 16
+        for (int b = 0; b < NB; ++b) xv[b] = _mm256_load_pd(xj + 4 * b);
+        #pragma GCC unroll 16
+        for (int r = 0; r < NR; ++r) {
+            __m256d ar = _mm256_broadcast_sd(a[r] + j);
+            #pragma GCC unroll 16
+            for (int b = 0; b < NB; ++b) acc[r][b] = _mm256_fmadd_pd(ar, xv[b], acc[r][b]);
+        }
+    }
+    #pragma GCC unroll 16
+    for (int r = 0; r < NR; ++r)
+        #pragma GCC unroll 16
+        for (int b = 0; b < NB; ++b) _mm256_store_pd(y[r] + c0 + 4 * b, acc[r][b]);
+}
+
+template <int NR>
+void bloque_rhs_escalar(const double* const* a, int j0, int j1, const double* X, double* const* y, size_t kp, int c0) {
+    double acc[NR][8] = {};
+    for (int j = j0; j < j1; ++j) {
+        const double* xj = X + (size_t)j * kp + c0;
+        #pragma GCC unroll 16
+        for (int r = 0; r < NR; ++r)
+            #pragma GCC unroll 16
+            for (int c = 0; c < 8; ++c) acc[r][c] += a[r][j] * xj[c];
+    }
+    #pragma GCC unroll 16
+    for (int r = 0; r < NR; ++r)
+        #pragma GCC unroll 16
+        for (int c = 0; c < 8; ++c) y[r][c0 + c] = (j0 == 0 ? 0.0 : y[r][c0 + c]) + acc[r][c];
+}
+
+// Recorre filas [fila_ini, fila_fin) en grupos de NR y las columnas de X en
+// grupos de ANCHO doubles; la última tanda de columnas usa un bloque más chico.
+// AVX-512: 4 filas x 4 zmm = 16 acumuladores; AVX2: 4 filas x 2 ymm = 8 (con
+// 3 ymm se usan los 16 registros y GCC derrama acumuladores a la pila).
+template <int NR>
+__attribute__((target("avx512f")))
+void filas_rhs_avx512(const MatrizDensa& A, int j0, int j1, const double* X, VecAlineado& Y, size_t kp, int i) {
+    const double* a[NR];
+    double* y[NR];
+    for (int r = 0; r < NR; ++r) a[r] = A.fila(i + r), y[r] = Y.data() + (size_t)(i + r) * kp;
+    int c = 0;
+    for (; c + 32 <= (int)kp; c += 32) bloque_rhs_avx512<NR, 4>(a, j0, j1, X, y, kp, c);
+    switch (((int)kp - c) / 8) {
+        case 3: bloque_rhs_avx512<NR, 3>(a, j0, j1, X, y, kp, c); break;
+        case 2: bloque_rhs_avx512<NR, 2>(a, j0, j1, X, y, kp, c); break;
+        case 1: bloque_rhs_avx512<NR, 1>(a, j0, j1, X, y, kp, c); break;
+    }
+}
+
+// Tramo de columnas de A: ~128 KB de X por tramo.
+int tramo_rhs(size_t kp) { return max(64, (int)(16384 / kp)); }
+
+void rhs_avx512(const MatrizDensa& A, const double* X, VecAlineado& Y, size_t kp, int fila_ini, int fila_fin) {
+    for (int j0 = 0, jt = tramo_rhs(kp); j0 < A.cols; j0 += jt) {
+        int j1 = min(A.cols, j0 + jt), i = fila_ini;
+        for (; i + 4 <= fila_fin; i += 4) filas_rhs_avx512<4>(A, j0, j1, X, Y, kp, i);
+        for (; i < fila_fin; ++i) filas_rhs_avx512<1>(A, j0, j1, X, Y, kp, i);
+    }
+}
+
+template <int NR>
+__attribute__((target("avx2,fma")))
+void filas_rhs_avx2(const MatrizDensa& A, int j0, int j1, const double* X, VecAlineado& Y, size_t kp, int i) {
+    const double* a[NR];
+    double* y[NR];
+    for (int r = 0; r < NR; ++r) a[r] = A.fila(i + r), y[r] = Y.data() + (size_t)(i + r) * kp;
+    for (int c = 0; c < (int)kp; c += 8) bloque_rhs_avx2<NR, 2>(a, j0, j1, X, y, kp, c);
+}
+
+void rhs_avx2(const MatrizDensa& A, const double* X, VecAlineado& Y, size_t kp, int fila_ini, int fila_fin) {
+    for (int j0 = 0, jt = tramo_rhs(kp); j0 < A.cols; j0 += jt) {
+        int j1 = min(A.cols, j0 + jt), i = fila_ini;
+        for (; i + 4 <= fila_fin; i += 4) filas_rhs_avx2<4>(A, j0, j1, X, Y, kp, i);
+        for (; i < fila_fin; ++i) filas_rhs_avx2<1>(A, j0, j1, X, Y, kp, i);
+    }
+}
+
+void rhs_escalar(const MatrizDensa& A, const double* X, VecAlineado& Y, size_t kp, int fila_ini, int fila_fin) {
+    for (int j0 = 0, jt = tramo_rhs(kp); j0 < A.cols; j0 += jt) {
+        int j1 = min(A.cols, j0 + jt);
+        for (int i = fila_ini; i < fila_fin; ++i) {
+            const double* a[1] = { A.fila(i) };
+            double* y[1] = { Y.data() + (size_t)i * kp };
+            for (int c = 0; c < (int)kp; c += 8) bloque_rhs_escalar<1>(a, j0, j1, X, y, kp, c);
+        }
+    }
+}
+
+using KernelRhs = void (*)(const MatrizDensa&, const double*, VecAlineado&, size_t, int, int);
+
+int main_rhs(int n, int m, int thread_count, const InfoKernel& kernel, int iteraciones,
+             const vector<int>& cpus, const vector<int>& lista_k) {
+    KernelRhs krhs = kernel.nombre == string("avx512") ? rhs_avx512
+                   : kernel.nombre == string("avx2")   ? rhs_avx2 : rhs_escalar;
+    const char* nombre_rhs = krhs == rhs_avx512 ? "avx512" : krhs == rhs_avx2 ? "avx2" : "escalar";
+    cout << "Matriz: " << n << "x" << m << ", Threads: " << thread_count
+         << ", Y = A·X, Kernel: " << nombre_rhs << "\n";
+
+    MatrizDensa A(n, m);
+    mt19937 gen(42);
+    uniform_real_distribution<double> dist(0.0, 1.0);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < m; ++j) A.fila(i)[j] = dist(gen);
+
+    int k_max = *max_element(lista_k.begin(), lista_k.end());
+    vector<VecAlineado> columnas(k_max, VecAlineado(m));   // X por columnas, para la referencia
+    for (auto& xc : columnas)
+        for (int j = 0; j < m; ++j) xc[j] = dist(gen);
+
+    PoolHilos pool(thread_count, cpus);
+    vector<int> corte = repartir(n, nullptr, thread_count);
+
+    // Referencia: un matvec por vector con el kernel normal. t1 es el tiempo de uno.
+    VecAlineado y1(n);
+    auto t0 = high_resolution_clock::now();
+    for (int it = 0; it < iteraciones; ++it)
+        pool.ejecutar([&](int id) {
+            worker(Task{ &A, columnas[0].data(), y1.data(), corte[id], corte[id + 1], kernel.f });
+        });
+    double ms_1 = duration<double, milli>(high_resolution_clock::now() - t0).count() / iteraciones;
+    cout << "1 matvec (kernel " << kernel.nombre << "): " << ms_1 << " ms, "
+         << 2.0 * n * m / (ms_1 * 1e6) << " GFLOP/s\n";
+    cout << "k, ms por pasada, ms por vector, GFLOP/s, aceleración vs k matvecs, dif. máxima\n";
+
+    for (int k : lista_k) {
+        size_t kp = ((size_t)k + 7) / 8 * 8;
+        VecAlineado X((size_t)m * kp, 0.0), Y((size_t)n * kp, 0.0);
+        for (int c = 0; c < k; ++c)
+            for (int j = 0; j < m; ++j) X[(size_t)j * kp + c] = columnas[c][j];
+
+        // k = 1 no gana nada con el formato intercalado (7 de 8 columnas serían
+        // relleno): se usa el kernel de un vector.
+        auto s = high_resolution_clock::now();
+        for (int it = 0; it < iteraciones; ++it)
+            pool.ejecutar([&](int id) {
+                if (k == 1) {
+                    for (int i = corte[id]; i < corte[id + 1]; ++i)
+                        Y[(size_t)i * kp] = kernel.f(A.fila(i), columnas[0].data(), m);
+                } else {
+                    krhs(A, X.data(), Y, kp, corte[id], corte[id + 1]);
+                }
+            });
+        double ms = duration<double, milli>(high_resolution_clock::now() - s).count() / iteraciones;
+
+        // Verificación contra matvecs sueltos (fuera de la medición)
+        double err = 0.0;
+        VecAlineado yc(n);
+        for (int c = 0; c < k; ++c) {
+            worker(Task{ &A, columnas[c].data(), yc.data(), 0, n, kernel.f });
+            for (int i = 0; i < n; ++i) err = max(err, fabs(Y[(size_t)i * kp + c] - yc[i]));
+        }
+        cout << k << ", " << ms << ", " << ms / k << ", " << 2.0 * n * m * k / (ms * 1e6) << ", "
+             << k * ms_1 / ms << "x, " << err << "\n";
+    }
+    return 0;
+}
+
 // ===== Programa principal =====
 int main(int argc, char* argv[]) {
     if (argc < 4) {
-        cerr << "Uso: " << argv[0] << " <filas> <columnas> <threads>\n";
+        cerr << "Uso: " << argv[0] << " <filas> <columnas> <threads> [--anidada] [--kernel=auto|escalar|sse2|avx2|avx512]"
+             << " [--modo=gemm] [--cols-b=P] [--sin-ingenuo]"
+             << " [--iteraciones=N] [--planificacion=dinamica|estatica] [--bloque=R] [--sin-pool]"
+             << " [--primer-toque] [--afinidad=ninguna|compacta|dispersa]"
+             << " [--modo=spmv] [--formato=csr|sell|ell] [--densidad=D] [--sesgo=S] [--sigma=S]"
+             << " [--reparto=nnz|filas] [--mtx=archivo] [--comparar-densa]"
+             << " [--escribir-bin=archivo] [--bin=archivo] [--prefault] [--escribir-y=archivo]"
+             << " [--stream=archivo] [--panel=R] [--precision=double|float|mixta|bf16] [--rhs=K[,K2,...]]\n";
         return 1;
     }
 
@@ -47,49 +1846,342 @@ int main(int argc, char* argv[]) {
     int m = stoi(argv[2]); // columnas
     int thread_count = stoi(argv[3]);
 
-    cout << "Matriz: " << n << "x" << m << ", Threads: " << thread_count << "\n";
+    bool anidada = false;
+    string kernel_pedido = "auto";
+    bool gemm = false, spmv = false, ingenuo = true;
+    OpcionesSpmv op_spmv;
+    int cols_b = m;
+    int iteraciones = 1, bloque = 64;
+    bool dinamica = true, usar_pool = true;
+    bool planif_explicita = false, primer_toque = false;
+    string afinidad = "ninguna";
+    string ruta_escribir, ruta_bin, ruta_y, ruta_stream;
+    int panel_filas = 0;
+    string precision = "double";
+    vector<int> lista_k;
+    bool prefault = false;
+    for (int a = 4; a < argc; ++a) {
+        string op = argv[a];
+        if (op == "--anidada") anidada = true;
+        else if (op.rfind("--kernel=", 0) == 0) kernel_pedido = op.substr(9);
+        else if (op == "--modo=gemm") gemm = true, spmv = false;
+        else if (op == "--modo=spmv") spmv = true, gemm = false;
+        else if (op == "--modo=matvec") gemm = spmv = false;
+        else if (op == "--formato=csr" || op == "--formato=sell" || op == "--formato=ell") op_spmv.formato = op.substr(10);
+        else if (op.rfind("--densidad=", 0) == 0) op_spmv.densidad = stod(op.substr(11));
+        else if (op.rfind("--sesgo=", 0) == 0) op_spmv.sesgo = stod(op.substr(8));
+        else if (op.rfind("--sigma=", 0) == 0) op_spmv.sigma = stoi(op.substr(8));
+        else if (op == "--reparto=nnz" || op == "--reparto=filas") op_spmv.reparto = op.substr(10);
+        else if (op.rfind("--mtx=", 0) == 0) op_spmv.mtx = op.substr(6);
+        else if (op == "--comparar-densa") op_spmv.comparar_densa = true;
+        else if (op.rfind("--cols-b=", 0) == 0) cols_b = stoi(op.substr(9));
+        else if (op == "--sin-ingenuo") ingenuo = false;
+        else if (op.rfind("--iteraciones=", 0) == 0) iteraciones = stoi(op.substr(14));
+        else if (op == "--planificacion=dinamica") dinamica = true, planif_explicita = true;
+        else if (op == "--planificacion=estatica") dinamica = false, planif_explicita = true;
+        else if (op.rfind("--bloque=", 0) == 0) bloque = stoi(op.substr(9));
+        else if (op == "--sin-pool") usar_pool = false;
+        else if (op == "--primer-toque") primer_toque = true;
+        else if (op == "--afinidad=ninguna" || op == "--afinidad=compacta" || op == "--afinidad=dispersa")
+            afinidad = op.substr(11);
+        else if (op.rfind("--escribir-bin=", 0) == 0) ruta_escribir = op.substr(15);
+        else if (op.rfind("--bin=", 0) == 0) ruta_bin = op.substr(6);
+        else if (op == "--prefault") prefault = true;
+        else if (op.rfind("--escribir-y=", 0) == 0) ruta_y = op.substr(13);
+        else if (op.rfind("--stream=", 0) == 0) ruta_stream = op.substr(9);
+        else if (op.rfind("--panel=", 0) == 0) panel_filas = stoi(op.substr(8));
+        else if (op == "--precision=double" || op == "--precision=float" || op == "--precision=mixta"
+                 || op == "--precision=bf16")
+            precision = op.substr(12);
+        else if (op.rfind("--rhs=", 0) == 0) {
+            stringstream ss(op.substr(6));
+            string k;
+            while (getline(ss, k, ',')) lista_k.push_back(stoi(k));
+            if (lista_k.empty() || *min_element(lista_k.begin(), lista_k.end()) < 1) {
+                cerr << "--rhs necesita valores >= 1\n";
+                return 1;
+            }
+        }
+        else { cerr << "Opcion desconocida: " << op << "\n"; return 1; }
+    }
+    if (iteraciones < 1 || bloque < 1) {
+        cerr << "--iteraciones y --bloque deben ser >= 1\n";
+        return 1;
+    }
+    if (primer_toque && anidada) {
+        cerr << "--primer-toque solo aplica al layout contiguo\n";
+        return 1;
+    }
+    if ((!ruta_bin.empty() || !ruta_escribir.empty()) && anidada) {
+        cerr << "--bin y --escribir-bin solo aplican al layout contiguo\n";
+        return 1;
+    }
+    if (!ruta_bin.empty() && (primer_toque || !ruta_escribir.empty())) {
+        cerr << "--bin no se combina con --primer-toque ni --escribir-bin\n";
+        return 1;
+    }
+    // El primer toque reparte las páginas por bloque estático; con planificación
+    // dinámica cada trozo puede caer en otro nodo, así que por defecto estática.
+    if (primer_toque && !planif_explicita) dinamica = false;
+
+    InfoKernel kernel = elegir_kernel(kernel_pedido);
+    if (!kernel.f) {
+        cerr << "Kernel no disponible en esta CPU: " << kernel_pedido << "\n";
+        return 1;
+    }
+
+    if (gemm) return main_gemm(n, m, cols_b, thread_count, kernel, ingenuo);
+
+    vector<int> cpus;
+    if (afinidad != "ninguna") cpus = orden_cpus(afinidad);
+    if (spmv) {
+        if (op_spmv.sigma < 1 || op_spmv.densidad < 0.0 || op_spmv.densidad > 1.0) {
+            cerr << "--sigma debe ser >= 1 y --densidad estar en [0, 1]\n";
+            return 1;
+        }
+        return main_spmv(n, m, thread_count, kernel, iteraciones, cpus, op_spmv);
+    }
+    if (!ruta_stream.empty())
+        return main_stream(ruta_stream, thread_count, kernel, iteraciones, panel_filas, cpus);
+    if (precision != "double") {
+        if (anidada || primer_toque || !ruta_bin.empty() || !ruta_escribir.empty() || !ruta_y.empty()) {
+            cerr << "--precision solo se combina con el layout contiguo en memoria\n";
+            return 1;
+        }
+        return main_precision(n, m, thread_count, kernel, iteraciones, cpus, precision);
+    }
+    if (!lista_k.empty())
+        return main_rhs(n, m, thread_count, kernel, iteraciones, cpus, lista_k);
+
+    // --bin: A es una vista sobre el archivo mapeado; nada se copia ni se lee
+    // hasta que un hilo toca la página (o el prefault la trae).
+    ArchivoMatriz archivo_A;
+    bool bin_copiar = false;
+    if (!ruta_bin.empty()) {
+        string error;
+        if (!archivo_A.abrir(ruta_bin, error)) {
+            cerr << "Error leyendo " << ruta_bin << ": " << error << "\n";
+            return 1;
+        }
+        n = (int)archivo_A.cabecera().filas;
+        m = (int)archivo_A.cabecera().cols;
+        // Un vector de --escribir-y (n x 1, ld = 1) se copia a una matriz con
+        // filas alineadas; cualquier otra matriz tiene que venir alineada.
+        bin_copiar = archivo_A.cabecera().ld % 8 != 0 && m == 1;
+        if (archivo_A.cabecera().ld % 8 != 0 && !bin_copiar) {
+            cerr << "Error: ld del archivo no es múltiplo de 8 (filas sin alinear)\n";
+            return 1;
+        }
+    }
+
+    cout << "Matriz: " << n << "x" << m << ", Threads: " << thread_count
+         << ", Layout: " << (anidada ? "anidado" : "contiguo")
+         << ", Kernel: " << (anidada ? "escalar (original)" : kernel.nombre) << "\n";
+
+    unique_ptr<PoolHilos> pool;
+    if (usar_pool) pool.reset(new PoolHilos(thread_count, cpus));   // fuera de la medición
+    auto en_paralelo = [&](const function<void(int)>& f) {
+        if (pool) pool->ejecutar(f);
+        else ejecutar_con_hilos(thread_count, cpus, f);
+    };
+
+    int rows_per_thread = n / thread_count;
+    int remainder = n % thread_count;
+    auto bloque_estatico = [&](int id) {
+        int start_row = id * rows_per_thread + min(id, remainder);
+        return make_pair(start_row, start_row + rows_per_thread + (id < remainder ? 1 : 0));
+    };
+
+    // --- Inicializar matriz y vector (mismo orden de números en ambos layouts) ---
+    // Con --primer-toque cada hilo escribe su bloque de filas: Linux coloca cada
+    // página en el nodo del hilo que la toca primero. Cada fila usa su propio
+    // generador (semilla 42 + i) para que A no dependa del número de hilos; los
+    // valores difieren de la inicialización secuencial.
+    // Con --bin, x usa otra semilla (7, como en spmv): con la 42 repetiría la
+    // primera fila de A.
+    MatrizDensa A = bin_copiar        ? MatrizDensa(n, m)
+                  : !ruta_bin.empty() ? MatrizDensa(n, m, (size_t)archivo_A.cabecera().ld, archivo_A.datos())
+                  : primer_toque      ? MatrizDensa(n, m, MatrizDensa::SinTocar{})
+                                      : MatrizDensa(anidada ? 0 : n, anidada ? 0 : m);
+    vector<vector<double>> A_anidada;
+    VecAlineado x(m), y(ruta_y.empty() ? n : 0);
+    vector<double> x_anidada, y_anidada;
 
-    // --- Inicializar matriz y vector ---
-    vector<vector<double>> A(n, vector<double>(m));
-    vector<double> x(m), y(n);
+    // --escribir-y: los hilos escriben y directamente en el archivo mapeado
+    // (n x 1, ld = 1); al terminar queda en disco sin una copia extra.
+    ArchivoMatriz archivo_y;
+    double* yp = y.data();
+    if (!ruta_y.empty()) {
+        string error;
+        if (!archivo_y.crear(ruta_y, n, 1, 1, error)) {
+            cerr << "Error creando " << ruta_y << ": " << error << "\n";
+            return 1;
+        }
+        yp = archivo_y.datos();
+    }
 
     mt19937 gen(42);
     uniform_real_distribution<double> dist(0.0, 1.0);
 
-    for (int i = 0; i < n; ++i)
-        for (int j = 0; j < m; ++j)
-            A[i][j] = dist(gen);
+    double ms_mapeo = 0.0;
+    if (bin_copiar) {
+        const double* v = archivo_A.datos();
+        for (int i = 0; i < n; ++i) A.fila(i)[0] = v[(size_t)i * archivo_A.cabecera().ld];
+    } else if (!ruta_bin.empty()) {
+        // Prefault: cada hilo lee un byte por página de su bloque de filas, en
+        // paralelo, para que los fallos de página no caigan en la medición.
+        if (prefault) {
+            auto t0 = high_resolution_clock::now();
+            en_paralelo([&](int id) {
+                auto [start_row, end_row] = bloque_estatico(id);
+                if (start_row == end_row) return;
+                const char* p = (const char*)A.fila(start_row);
+                const char* fin = (const char*)A.fila(end_row);
+                volatile char suma = 0;
+                for (; p < fin; p += 4096) suma = suma + *p;
+            });
+            ms_mapeo = duration<double, milli>(high_resolution_clock::now() - t0).count();
+        }
+    } else if (anidada) {
+        A_anidada.assign(n, vector<double>(m));
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < m; ++j)
+                A_anidada[i][j] = dist(gen);
+    } else if (primer_toque) {
+        en_paralelo([&](int id) {
+            auto [start_row, end_row] = bloque_estatico(id);
+            uniform_real_distribution<double> d(0.0, 1.0);
+            for (int i = start_row; i < end_row; ++i) {
+                mt19937 g(42u + (unsigned)i);
+                double* a = A.fila(i);
+                for (int j = 0; j < m; ++j) a[j] = d(g);
+                fill(a + m, a + A.ld, 0.0);
+                yp[i] = 0.0;
+            }
+        });
+    } else {
+        for (int i = 0; i < n; ++i) {
+            double* a = A.fila(i);
+            for (int j = 0; j < m; ++j)
+                a[j] = dist(gen);
+        }
+    }
 
+    if (!ruta_bin.empty()) gen.seed(7);
     for (int j = 0; j < m; ++j)
         x[j] = dist(gen);
+    if (!ruta_escribir.empty()) {
+        auto t0 = high_resolution_clock::now();
+        ArchivoMatriz salida;
+        string error;
+        if (!salida.crear(ruta_escribir, n, m, (int64_t)A.ld, error)) {
+            cerr << "Error creando " << ruta_escribir << ": " << error << "\n";
+            return 1;
+        }
+        memcpy(salida.datos(), A.fila(0), (size_t)n * A.ld * sizeof(double));
+        cout << "A escrita en " << ruta_escribir << " ("
+             << (double)n * A.ld * sizeof(double) / 1e6 << " MB, "
+             << duration<double>(high_resolution_clock::now() - t0).count() << " s)\n";
+    }
+    if (anidada) {
+        x_anidada.assign(x.begin(), x.end());
+        y_anidada.assign(n, 0.0);
+    }
 
     // --- Multiplicación paralela ---
-    vector<thread> threads;
-    vector<Task> tasks(thread_count);
+    // Estática: el hilo id recibe siempre el mismo bloque de filas.
+    // Dinámica: los hilos piden trozos de 'bloque' filas a un contador atómico,
+    // así un núcleo lento (o interrumpido) solo retrasa su último trozo.
+    atomic<int> siguiente{0};
+    vector<double> ms_hilo(thread_count, 0.0);
+    vector<long> filas_hilo(thread_count, 0);
 
-    int rows_per_thread = n / thread_count;
-    int remainder = n % thread_count;
+    auto filas = [&](int start_row, int end_row) {
+        if (anidada)
+            worker_anidada(TaskAnidada{ &A_anidada, &x_anidada, &y_anidada, start_row, end_row });
+        else
+            worker(Task{ &A, x.data(), yp, start_row, end_row, kernel.f });
+    };
+    function<void(int)> trabajo = [&](int id) {
+        auto t0 = high_resolution_clock::now();
+        long hechas = 0;
+        if (dinamica) {
+            for (;;) {
+                int s = siguiente.fetch_add(bloque, memory_order_relaxed);
+                if (s >= n) break;
+                filas(s, min(n, s + bloque));
+                hechas += min(n, s + bloque) - s;
+            }
+        } else {
+            auto [start_row, end_row] = bloque_estatico(id);
+            filas(start_row, end_row);
+            hechas = end_row - start_row;
+        }
+        ms_hilo[id] += duration<double, milli>(high_resolution_clock::now() - t0).count();
+        filas_hilo[id] += hechas;
+    };
+
+    // Iteración de potencia: con A cuadrada, x <- y / ||y|| entre llamadas y
+    // ||y|| converge al mayor valor propio (en módulo). Si no es cuadrada se
+    // repite la misma multiplicación.
+    bool potencia = iteraciones > 1 && n == m;
+    double norma = 0.0;
 
     auto start = high_resolution_clock::now();
 
-    int current = 0;
-    for (int t = 0; t < thread_count; ++t) {
-        int start_row = current;
-        int end_row = start_row + rows_per_thread + (t < remainder ? 1 : 0);
-        current = end_row;
+    for (int it = 0; it < iteraciones; ++it) {
+        siguiente.store(0, memory_order_relaxed);
+        en_paralelo(trabajo);
 
-        tasks[t] = { &A, &x, &y, start_row, end_row };
-        threads.emplace_back(worker, tasks[t]);
+        if (potencia) {
+            const double* yy = anidada ? y_anidada.data() : yp;
+            double* xx = anidada ? x_anidada.data() : x.data();
+            double s2 = 0.0;
+            for (int i = 0; i < n; ++i) s2 += yy[i] * yy[i];
+            norma = sqrt(s2);
+            if (it + 1 < iteraciones)
+                for (int i = 0; i < n; ++i) xx[i] = yy[i] / norma;
+        }
     }
 
-    for (auto& th : threads) th.join();
-
     auto end = high_resolution_clock::now();
     double time_ms = duration<double, milli>(end - start).count();
+    if (anidada) copy(y_anidada.begin(), y_anidada.end(), yp);
+
+    // A se lee una vez; x e y una vez cada uno (x queda en caché entre filas)
+    double bytes = 8.0 * ((double)n * m + m + n) * iteraciones;
 
+    cout << "Planificacion: " << (dinamica ? "dinamica (bloque " + to_string(bloque) + ")" : string("estatica"))
+         << ", Hilos: " << (pool ? "pool persistente" : "nuevos por llamada") << "\n";
+    if (primer_toque || !cpus.empty())
+        cout << "Primer toque: " << (primer_toque ? "por hilo" : "hilo principal")
+             << ", Afinidad: " << afinidad << "\n";
+    if (!ruta_bin.empty())
+        cout << "A mapeada desde " << ruta_bin << (prefault ? ", prefault: " + to_string(ms_mapeo / 1000.0) + " s" : string(", sin prefault")) << "\n";
+    if (!ruta_y.empty()) cout << "y escrita en " << ruta_y << "\n";
     cout << "Tiempo total: " << time_ms / 1000.0 << " s\n";
+    // Tiempo dentro de la multiplicación por hilo (acumulado en todas las
+    // llamadas): un hilo que lee memoria remota aparece como el más lento.
+    double ms_max = 0.0, ms_suma = 0.0;
+    cout << "Tiempo por hilo (ms, filas):";
+    for (int t = 0; t < thread_count; ++t) {
+        cout << " h" << t;
+        if (!cpus.empty()) cout << "@cpu" << cpus[t % cpus.size()];
+        cout << "=" << ms_hilo[t] << " (" << filas_hilo[t] << ")";
+        ms_max = max(ms_max, ms_hilo[t]);
+        ms_suma += ms_hilo[t];
+    }
+    cout << "\n";
+    cout << "Desbalance (max/media): " << ms_max / (ms_suma / thread_count) << "\n";
+    if (iteraciones > 1)
+        cout << "Llamadas: " << iteraciones << ", latencia media por llamada: "
+             << time_ms / iteraciones << " ms\n";
+    cout << "Rendimiento: " << 2.0 * n * m * iteraciones / (time_ms * 1e6) << " GFLOP/s\n";
+    cout << "Ancho de banda efectivo: " << bytes / (time_ms * 1e6) << " GB/s\n";
+    if (potencia)
+        cout << "Valor propio dominante estimado (||A·x||): " << norma << "\n";
     cout << "Primeros 5 valores de y: ";
-    for (int i = 0; i < min(5, n); ++i) cout << y[i] << " ";
+    for (int i = 0; i < min(5, n); ++i) cout << yp[i] << " ";
     cout << "\n";
 
     return 0;
@@ -1,13 +1,33 @@
 // lista_mt.cpp
-// Lista enlazada ordenada de int (sin duplicados) con 3 estrategias: coarse, fine, rw.
+// Lista enlazada ordenada de int (sin duplicados) con varias estrategias de sincronización.
 // C++17, -pthread. Salida mínima: tiempos y resumen de operaciones.
 //
 // Compilar:
 //   g++ -O2 -std=c++17 -pthread -o lista_mt lista_mt.cpp
+//   (incluye ../locks.hpp; compilar desde lab_lunes13_Oc o con -I..)
 //
 // Uso:
-//   ./lista_mt <strategy> <threads> <ops_por_thread> <member_pct> <insert_pct> <delete_pct> <init_n> <key_max> <seed>
-//   strategy: coarse | fine | rw
+//   ./lista_mt <strategy> <threads> <ops_por_thread> <member_pct> <insert_pct> <delete_pct> <init_n> <key_max> <seed> [opciones]
+//   strategy: coarse | fine | rw | lockfree | optimistic | lazy | skiplist | hash |
+//             unrolled | unrolled-rw
+//   opciones:
+//     --sin-pool       nodos con new/delete en vez del pool por hilo (para comparar)
+//     --sin-compactar  no reorganiza los nodos tras la carga inicial (unrolled)
+//     --rwlock=<tipo>  lock de rw / unrolled-rw: std (shared_mutex, por defecto) |
+//                      bigreader | writerpref | rcu (sólo rw: lectores sin lock)
+//     --lock=<tipo>    lock de coarse / fine: std (std::mutex, por defecto) |
+//                      tas | ttas | ticket | mcs | clh | hibrido (ver locks.hpp)
+//                      Los FIFO (ticket, mcs, clh) con más hilos que núcleos se
+//                      degradan mucho: el siguiente en la cola puede no estar
+//                      corriendo (p. ej. coarse + ticket, 8 hilos en 1 núcleo).
+//     --contadores-compartidos  contadores atómicos comunes (modo anterior) en vez
+//                      de contadores por hilo sumados al final
+//     --muestreo=N     mide la latencia de 1 de cada N ops (por defecto 8; 0 = no mide)
+//     --formato=<f>    texto (por defecto) | csv | json
+//     --lote=B         B claves ordenadas por llamada (MemberBatch/InsertBatch/
+//                      DeleteBatch, B <= 2^20); las latencias pasan a ser por lote
+//     --carga-paralela[=H]  carga inicial masiva: genera y ordena las claves con
+//                      H hilos (por defecto, todos los núcleos) y enlaza en una pasada
 //
 // Ejemplos (como el PDF):
 //   # 100000 ops/hilo, 99.9/0.05/0.05
@@ -21,6 +41,7 @@
 #include <atomic>
 #include <random>
 #include <chrono>
+#include "../locks.hpp"
 using namespace std;
 
 // --------- utilidades ----------
@@ -34,36 +55,276 @@ struct Timer {
     }
 };
 
+// Histograma log-lineal al estilo HDR: 2^SUB_BITS sub-cubetas por potencia de
+// dos (error relativo < 1/32). Uno por hilo y operación; se suman al final.
+struct Histograma {
+    static constexpr int SUB_BITS = 5, SUB = 1 << SUB_BITS, CUBETAS = (64 - SUB_BITS + 1) * SUB;
+    std::array<uint64_t, CUBETAS> cubetas{};
+    uint64_t n = 0, max = 0;
+
+    static int indice(uint64_t v) {
+        if (v < (uint64_t)SUB) return (int)v;
+        int desplaz = 63 - __builtin_clzll(v) - SUB_BITS;
+        return (desplaz + 1) * SUB + (int)((v >> desplaz) & (SUB - 1));
+    }
+    // Menor valor que cae en la cubeta i.
+    static uint64_t limite(int i) {
+        if (i < SUB) return (uint64_t)i;
+        int desplaz = i / SUB - 1;
+        return (uint64_t)(SUB + i % SUB) << desplaz;
+    }
+
+    void registrar(uint64_t v) { ++cubetas[indice(v)]; ++n; if (v > max) max = v; }
+
+    void sumar(const Histograma& o) {
+        for (int i = 0; i < CUBETAS; ++i) cubetas[i] += o.cubetas[i];
+        n += o.n; max = std::max(max, o.max);
+    }
+
+    // Valor más alto de la cubeta que contiene el percentil p (0-100).
+    uint64_t percentil(double p) const {
+        if (n == 0) return 0;
+        uint64_t objetivo = std::max<uint64_t>(1, (uint64_t)std::ceil(p / 100.0 * n));
+        uint64_t acum = 0;
+        for (int i = 0; i < CUBETAS; ++i) {
+            acum += cubetas[i];
+            if (acum >= objetivo) return std::min(limite(i + 1) - 1, max);
+        }
+        return max;
+    }
+};
+
 struct IList {
     virtual bool Member(int key) = 0;
     virtual bool Insert(int key) = 0;
     virtual bool Delete(int key) = 0;
+
+    // Lotes: keys ordenadas de menor a mayor; devuelven cuántas tuvieron éxito.
+    // Por defecto una operación simple por clave; las listas con lock global
+    // o lock coupling los resuelven en un solo recorrido.
+    virtual size_t MemberBatch(const int* keys, size_t n) {
+        size_t ok = 0;
+        for (size_t i = 0; i < n; ++i) ok += Member(keys[i]);
+        return ok;
+    }
+    virtual size_t InsertBatch(const int* keys, size_t n) {
+        size_t ok = 0;
+        for (size_t i = 0; i < n; ++i) ok += Insert(keys[i]);
+        return ok;
+    }
+    virtual size_t DeleteBatch(const int* keys, size_t n) {
+        size_t ok = 0;
+        for (size_t i = 0; i < n; ++i) ok += Delete(keys[i]);
+        return ok;
+    }
+
+    // Visita en orden las claves presentes en [lo, hi]. Por defecto prueba
+    // cada valor con Member (sirve para estructuras sin orden, como hash).
+    virtual void RangeScan(int lo, int hi, const std::function<void(int)>& visitar) {
+        for (long k = lo; k <= hi; ++k)
+            if (Member((int)k)) visitar((int)k);
+    }
+
+    // Carga inicial con claves ordenadas y sin repetir, sobre la estructura
+    // vacía y sin hilos concurrentes. Por defecto inserta de mayor a menor:
+    // en una lista ordenada cada Insert se resuelve en la cabeza.
+    virtual void CargaMasiva(const std::vector<int>& claves) {
+        for (auto it = claves.rbegin(); it != claves.rend(); ++it) Insert(*it);
+    }
+
+    // Reorganiza la memoria tras la carga inicial (sin hilos concurrentes).
+    virtual void Compactar() {}
     virtual ~IList() = default;
 };
 
+// --------- pool de nodos ----------
+// Listas libres por hilo (sin locks) con desborde a una lista global, sobre
+// slabs de 64 KiB alineados a su tamaño: la cabecera del slab guarda la clase
+// de tamaño, así liberar() no necesita saber el tamaño del nodo. Clases de
+// 16 B en 16 B hasta 512 B. Con --sin-pool todo va directo a new/delete.
+namespace pool {
+static bool activo = true;
+static constexpr size_t GRANO = 16, CLASES = 32, LOTE = 64;
+static constexpr size_t SLAB = 64 * 1024, CABECERA = 64;
+
+struct Bloque { Bloque* sig; };
+
+struct Global {
+    std::mutex m;
+    Bloque* libres[CLASES + 1] = {};
+    size_t cuenta[CLASES + 1] = {};
+    std::vector<void*> slabs;
+    std::atomic<uint64_t> reservas{0}, liberaciones{0};
+    ~Global() { for (void* s : slabs) std::free(s); }
+};
+static Global& global() { static Global g; return g; }
+
+struct Cache {
+    Bloque* libres[CLASES + 1] = {};
+    size_t cuenta[CLASES + 1] = {};
+    uint64_t reservas = 0, liberaciones = 0;
+
+    // Pasa hasta n bloques de la clase k de esta caché a la global.
+    void devolver(size_t k, size_t n) {
+        if (!libres[k] || n == 0) return;
+        Bloque* primero = libres[k]; Bloque* ultimo = primero; size_t movidos = 1;
+        while (movidos < n && ultimo->sig) { ultimo = ultimo->sig; ++movidos; }
+        libres[k] = ultimo->sig; cuenta[k] -= movidos;
+        Global& g = global();
+        std::lock_guard<std::mutex> lk(g.m);
+        ultimo->sig = g.libres[k]; g.libres[k] = primero; g.cuenta[k] += movidos;
+    }
+
+    // Trae un lote de la global o, si está vacía, corta un slab nuevo.
+    void rellenar(size_t k) {
+        Global& g = global();
+        std::lock_guard<std::mutex> lk(g.m);
+        if (g.libres[k]) {
+            Bloque* primero = g.libres[k]; Bloque* ultimo = primero; size_t movidos = 1;
+            while (movidos < LOTE && ultimo->sig) { ultimo = ultimo->sig; ++movidos; }
+            g.libres[k] = ultimo->sig; g.cuenta[k] -= movidos;
+            ultimo->sig = libres[k]; libres[k] = primero; cuenta[k] += movidos;
+            return;
+        }
+        char* s = static_cast<char*>(std::aligned_alloc(SLAB, SLAB));
+        if (!s) throw std::bad_alloc();
+        g.slabs.push_back(s);
+        *reinterpret_cast<size_t*>(s) = k;
+        size_t tam = k * GRANO, n = (SLAB - CABECERA) / tam;
+        for (size_t i = n; i-- > 0; ) {   // al revés: salen en orden de dirección
+            Bloque* b = reinterpret_cast<Bloque*>(s + CABECERA + i * tam);
+            b->sig = libres[k]; libres[k] = b;
+        }
+        cuenta[k] += n;
+    }
+
+    ~Cache() {
+        for (size_t k = 1; k <= CLASES; ++k) devolver(k, cuenta[k]);
+        global().reservas += reservas;
+        global().liberaciones += liberaciones;
+    }
+};
+static thread_local Cache cache;
+
+static void* reservar(size_t bytes) {
+    Cache& c = cache;
+    ++c.reservas;
+    if (!activo) return ::operator new(bytes);
+    size_t k = (bytes + GRANO - 1) / GRANO;
+    if (k > CLASES) throw std::bad_alloc();
+    if (!c.libres[k]) c.rellenar(k);
+    Bloque* b = c.libres[k];
+    c.libres[k] = b->sig; --c.cuenta[k];
+    return b;
+}
+
+static void liberar(void* p) {
+    if (!p) return;
+    Cache& c = cache;
+    ++c.liberaciones;
+    if (!activo) { ::operator delete(p); return; }
+    size_t k = *reinterpret_cast<size_t*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(SLAB - 1));
+    Bloque* b = static_cast<Bloque*>(p);
+    b->sig = c.libres[k]; c.libres[k] = b;
+    if (++c.cuenta[k] > 2 * LOTE) c.devolver(k, LOTE);
+}
+
+struct Estadisticas { uint64_t reservas, liberaciones, slabs; };
+
+// Totales de los hilos que ya terminaron más los del hilo actual.
+static Estadisticas estadisticas() {
+    Global& g = global();
+    std::lock_guard<std::mutex> lk(g.m);
+    return { g.reservas.load() + cache.reservas, g.liberaciones.load() + cache.liberaciones,
+             (uint64_t)g.slabs.size() };
+}
+} // namespace pool
+
+// Base vacía para los nodos: new/delete pasan por el pool.
+struct EnPool {
+    static void* operator new(size_t sz) { return pool::reservar(sz); }
+    static void operator delete(void* p) { pool::liberar(p); }
+};
+
 // --------- Nodo base ----------
-struct Node {
+struct Node : EnPool {
     int key;
     Node* next;
     explicit Node(int k): key(k), next(nullptr) {}
 };
 
+// Lotes en un solo recorrido sobre una lista de Node (coarse y rw). Se
+// llaman con el lock ya tomado; keys viene ordenado.
+static size_t member_lote(Node* head, const int* keys, size_t n) {
+    size_t ok = 0; Node* cur = head;
+    for (size_t i = 0; i < n; ++i) {
+        while (cur && cur->key < keys[i]) cur = cur->next;
+        if (cur && cur->key == keys[i]) ++ok;
+    }
+    return ok;
+}
+
+static size_t insert_lote(Node*& head, const int* keys, size_t n) {
+    size_t ok = 0; Node* pred = nullptr; Node* cur = head;
+    for (size_t i = 0; i < n; ++i) {
+        while (cur && cur->key < keys[i]) { pred = cur; cur = cur->next; }
+        if ((cur && cur->key == keys[i]) || (pred && pred->key == keys[i])) continue;   // ya estaba o repetida en el lote
+        Node* nuevo = new Node(keys[i]);
+        nuevo->next = cur;
+        if (!pred) head = nuevo; else pred->next = nuevo;
+        pred = nuevo; ++ok;
+    }
+    return ok;
+}
+
+static size_t delete_lote(Node*& head, const int* keys, size_t n) {
+    size_t ok = 0; Node* pred = nullptr; Node* cur = head;
+    for (size_t i = 0; i < n; ++i) {
+        while (cur && cur->key < keys[i]) { pred = cur; cur = cur->next; }
+        if (!cur || cur->key != keys[i]) continue;
+        Node* sig = cur->next;
+        if (!pred) head = sig; else pred->next = sig;
+        delete cur; cur = sig; ++ok;
+    }
+    return ok;
+}
+
+// Encadena claves ordenadas en una sola pasada (carga masiva de Node/FGNodeT).
+template <class N>
+static N* enlazar(const std::vector<int>& claves) {
+    N* head = nullptr; N* ultimo = nullptr;
+    for (int k : claves) {
+        N* n = new N(k);
+        if (ultimo) ultimo->next = n; else head = n;
+        ultimo = n;
+    }
+    return head;
+}
+
+static void rango(Node* head, int lo, int hi, const std::function<void(int)>& visitar) {
+    Node* cur = head;
+    while (cur && cur->key < lo) cur = cur->next;
+    for (; cur && cur->key <= hi; cur = cur->next) visitar(cur->key);
+}
+
 // --------- 1) coarse: mutex global ----------
+// M es std::mutex por defecto; con --lock se usa uno de locks.hpp.
+template <class M = std::mutex>
 class ListCoarse : public IList {
     Node* head{nullptr};
-    mutable std::mutex m;
+    mutable M m;
 public:
     ~ListCoarse() override { clear(); }
 
     bool Member(int key) override {
-        std::lock_guard<std::mutex> lk(m);
+        std::lock_guard<M> lk(m);
         Node* cur = head;
         while (cur && cur->key < key) cur = cur->next;
         return (cur && cur->key == key);
     }
 
     bool Insert(int key) override {
-        std::lock_guard<std::mutex> lk(m);
+        std::lock_guard<M> lk(m);
         Node* pred = nullptr; Node* cur = head;
         while (cur && cur->key < key) { pred = cur; cur = cur->next; }
         if (cur && cur->key == key) return false;
@@ -74,7 +335,7 @@ public:
     }
 
     bool Delete(int key) override {
-        std::lock_guard<std::mutex> lk(m);
+        std::lock_guard<M> lk(m);
         Node* pred = nullptr; Node* cur = head;
         while (cur && cur->key < key) { pred = cur; cur = cur->next; }
         if (!cur || cur->key != key) return false;
@@ -82,8 +343,29 @@ public:
         delete cur; return true;
     }
 
+    size_t MemberBatch(const int* keys, size_t n) override {
+        std::lock_guard<M> lk(m);
+        return member_lote(head, keys, n);
+    }
+    void CargaMasiva(const std::vector<int>& claves) override {
+        std::lock_guard<M> lk(m);
+        head = enlazar<Node>(claves);
+    }
+    size_t InsertBatch(const int* keys, size_t n) override {
+        std::lock_guard<M> lk(m);
+        return insert_lote(head, keys, n);
+    }
+    size_t DeleteBatch(const int* keys, size_t n) override {
+        std::lock_guard<M> lk(m);
+        return delete_lote(head, keys, n);
+    }
+    void RangeScan(int lo, int hi, const std::function<void(int)>& visitar) override {
+        std::lock_guard<M> lk(m);
+        rango(head, lo, hi, visitar);
+    }
+
     void clear() {
-        std::lock_guard<std::mutex> lk(m);
+        std::lock_guard<M> lk(m);
         Node* cur = head;
         while (cur) { Node* tmp = cur; cur = cur->next; delete tmp; }
         head = nullptr;
@@ -91,123 +373,158 @@ public:
 };
 
 // --------- 2) fine-grained: lock por nodo (lock coupling) ----------
-struct FGNode {
-    int key; FGNode* next; mutable std::mutex m;
-    explicit FGNode(int k): key(k), next(nullptr) {}
+template <class M>
+struct FGNodeT : EnPool {
+    int key; FGNodeT* next; mutable M m;
+    explicit FGNodeT(int k): key(k), next(nullptr) {}
 };
 
+// Igual que coarse, M es el tipo de lock de head_m y de cada nodo.
+template <class M = std::mutex>
 class ListFine : public IList {
+    using FGNode = FGNodeT<M>;
     FGNode* head{nullptr};
-    mutable std::mutex head_m;
-public:
-    ~ListFine() override { clear(); }
+    mutable M head_m;
 
-    bool Member(int key) override {
+    // Recorrido con lock coupling para lotes: head_m se mantiene mientras no
+    // haya predecesor (puede tocar head) y se suelta al pasar el primer nodo.
+    struct Cursor {
+        std::unique_lock<M> lh;
         FGNode* pred = nullptr;
-        FGNode* cur  = nullptr;
-        {
-            std::lock_guard<std::mutex> lk(head_m);
-            cur = head;
-            if (cur) cur->m.lock();
-        }
-        bool found = false;
-        while (cur && cur->key < key) {
+        FGNode* cur = nullptr;
+
+        explicit Cursor(ListFine& l): lh(l.head_m), cur(l.head) { if (cur) cur->m.lock(); }
+        ~Cursor() {
+            if (cur) cur->m.unlock();
             if (pred) pred->m.unlock();
-            pred = cur;
-            cur = cur->next;
-            if (cur) cur->m.lock();
         }
-        if (cur && cur->key == key) found = true;
-        if (cur) cur->m.unlock();
-        if (pred) pred->m.unlock();
-        return found;
+        void avanzar(int key) {
+            while (cur && cur->key < key) {
+                if (pred) pred->m.unlock(); else lh.unlock();
+                pred = cur;
+                cur = cur->next;
+                if (cur) cur->m.lock();
+            }
+        }
+    };
+
+public:
+    ~ListFine() override { clear(); }
+
+    // Las operaciones sueltas usan el mismo Cursor que los lotes: head_m se
+    // suelta recién al pasar el primer nodo. Así nadie toma head_m teniendo un
+    // nodo (orden siempre head_m -> nodos) y nadie puede estar esperando el
+    // lock de un nodo que se borra, porque para llegar a él hace falta el lock
+    // de su predecesor (o head_m), que tiene quien borra.
+    bool Member(int key) override {
+        Cursor c(*this);
+        c.avanzar(key);
+        return c.cur && c.cur->key == key;
     }
 
     bool Insert(int key) override {
-        FGNode* pred = nullptr;
-        FGNode* cur  = nullptr;
-        {
-            std::lock_guard<std::mutex> lk(head_m);
-            cur = head;
-            if (cur) cur->m.lock();
-        }
-        while (cur && cur->key < key) {
-            if (pred) pred->m.unlock();
-            pred = cur;
-            cur = cur->next;
-            if (cur) cur->m.lock();
-        }
-        if (cur && cur->key == key) {
-            if (cur) cur->m.unlock();
-            if (pred) pred->m.unlock();
-            return false;
-        }
+        Cursor c(*this);
+        c.avanzar(key);
+        if (c.cur && c.cur->key == key) return false;
         FGNode* n = new FGNode(key);
-        n->next = cur;
-        if (!pred) {
-            std::lock_guard<std::mutex> lk(head_m);
-            head = n;
-        } else {
-            pred->next = n;
-        }
-        if (cur) cur->m.unlock();
-        if (pred) pred->m.unlock();
+        n->next = c.cur;
+        if (!c.pred) head = n; else c.pred->next = n;
         return true;
     }
 
     bool Delete(int key) override {
-        FGNode* pred = nullptr;
-        FGNode* cur  = nullptr;
-        {
-            std::lock_guard<std::mutex> lk(head_m);
-            cur = head;
-            if (cur) cur->m.lock();
+        Cursor c(*this);
+        c.avanzar(key);
+        if (!c.cur || c.cur->key != key) return false;
+        if (!c.pred) head = c.cur->next; else c.pred->next = c.cur->next;
+        c.cur->m.unlock();
+        delete c.cur;
+        c.cur = nullptr;
+        return true;
+    }
+
+    void CargaMasiva(const std::vector<int>& claves) override {
+        std::lock_guard<M> lk(head_m);
+        head = enlazar<FGNode>(claves);
+    }
+
+    size_t MemberBatch(const int* keys, size_t n) override {
+        Cursor c(*this);
+        size_t ok = 0;
+        for (size_t i = 0; i < n; ++i) {
+            c.avanzar(keys[i]);
+            if (c.cur && c.cur->key == keys[i]) ++ok;
         }
-        while (cur && cur->key < key) {
-            if (pred) pred->m.unlock();
-            pred = cur;
-            cur = cur->next;
-            if (cur) cur->m.lock();
+        return ok;
+    }
+
+    size_t InsertBatch(const int* keys, size_t n) override {
+        Cursor c(*this);
+        size_t ok = 0;
+        for (size_t i = 0; i < n; ++i) {
+            c.avanzar(keys[i]);
+            if ((c.cur && c.cur->key == keys[i]) || (c.pred && c.pred->key == keys[i])) continue;
+            FGNode* nuevo = new FGNode(keys[i]);
+            nuevo->m.lock();   // pasa a ser el nuevo pred
+            nuevo->next = c.cur;
+            if (!c.pred) { head = nuevo; c.lh.unlock(); }
+            else { c.pred->next = nuevo; c.pred->m.unlock(); }
+            c.pred = nuevo; ++ok;
         }
-        if (!cur || cur->key != key) {
-            if (cur) cur->m.unlock();
-            if (pred) pred->m.unlock();
-            return false;
+        return ok;
+    }
+
+    size_t DeleteBatch(const int* keys, size_t n) override {
+        Cursor c(*this);
+        size_t ok = 0;
+        for (size_t i = 0; i < n; ++i) {
+            c.avanzar(keys[i]);
+            if (!c.cur || c.cur->key != keys[i]) continue;
+            FGNode* sig = c.cur->next;
+            if (!c.pred) head = sig; else c.pred->next = sig;
+            if (sig) sig->m.lock();
+            c.cur->m.unlock();
+            delete c.cur;
+            c.cur = sig; ++ok;
         }
-        if (!pred) {
-            std::lock_guard<std::mutex> lk(head_m);
-            head = cur->next;
-        } else {
-            pred->next = cur->next;
+        return ok;
+    }
+
+    void RangeScan(int lo, int hi, const std::function<void(int)>& visitar) override {
+        Cursor c(*this);
+        c.avanzar(lo);
+        while (c.cur && c.cur->key <= hi) {
+            visitar(c.cur->key);
+            if (c.cur->key == hi) break;
+            c.avanzar(c.cur->key + 1);
         }
-        cur->m.unlock();
-        if (pred) pred->m.unlock();
-        delete cur; return true;
     }
 
     void clear() {
-        std::lock_guard<std::mutex> lk(head_m);
+        std::lock_guard<M> lk(head_m);
         FGNode* cur = head; head = nullptr;
         while (cur) { FGNode* tmp = cur; cur = cur->next; delete tmp; }
     }
 };
 
-// --------- 3) rw: shared_mutex global ----------
+// --------- 3) rw: lock lector/escritor global ----------
+// RWL es std::shared_mutex por defecto; ver --rwlock para las alternativas.
+template <class RWL = std::shared_mutex>
 class ListRW : public IList {
     Node* head{nullptr};
-    mutable std::shared_mutex rw;
+    mutable RWL rw;
 public:
     ~ListRW() override { clear(); }
 
     bool Member(int key) override {
-        std::shared_lock<std::shared_mutex> r(rw);
+        std::shared_lock<RWL> r(rw);
         Node* cur = head;
         while (cur && cur->key < key) cur = cur->next;
         return (cur && cur->key == key);
     }
 
     bool Insert(int key) override {
-        std::unique_lock<std::shared_mutex> w(rw);
+        std::unique_lock<RWL> w(rw);
         Node* pred = nullptr; Node* cur = head;
         while (cur && cur->key < key) { pred = cur; cur = cur->next; }
         if (cur && cur->key == key) return false;
@@ -218,7 +535,7 @@ public:
     }
 
     bool Delete(int key) override {
-        std::unique_lock<std::shared_mutex> w(rw);
+        std::unique_lock<RWL> w(rw);
         Node* pred = nullptr; Node* cur = head;
         while (cur && cur->key < key) { pred = cur; cur = cur->next; }
         if (!cur || cur->key != key) return false;
@@ -226,14 +543,886 @@ public:
         delete cur; return true;
     }
 
+    size_t MemberBatch(const int* keys, size_t n) override {
+        std::shared_lock<RWL> r(rw);
+        return member_lote(head, keys, n);
+    }
+    void CargaMasiva(const std::vector<int>& claves) override {
+        std::unique_lock<RWL> w(rw);
+        head = enlazar<Node>(claves);
+    }
+    size_t InsertBatch(const int* keys, size_t n) override {
+        std::unique_lock<RWL> w(rw);
+        return insert_lote(head, keys, n);
+    }
+    size_t DeleteBatch(const int* keys, size_t n) override {
+        std::unique_lock<RWL> w(rw);
+        return delete_lote(head, keys, n);
+    }
+    void RangeScan(int lo, int hi, const std::function<void(int)>& visitar) override {
+        std::shared_lock<RWL> r(rw);
+        rango(head, lo, hi, visitar);
+    }
+
     void clear() {
-        std::unique_lock<std::shared_mutex> w(rw);
+        std::unique_lock<RWL> w(rw);
         Node* cur = head;
         while (cur) { Node* tmp = cur; cur = cur->next; delete tmp; }
         head = nullptr;
     }
 };
 
+// --------- 4) lockfree: lista de Harris/Michael + reclamación por épocas ----------
+// El bit 0 de next marca el nodo como borrado lógicamente; el enlace físico se
+// quita después con CAS sobre el next del predecesor.
+struct LFNode : EnPool {
+    int key;
+    std::atomic<uintptr_t> next;
+    explicit LFNode(int k): key(k), next(0) {}
+};
+
+static constexpr int MAX_HILOS = 256;
+static std::atomic<int> hilos_registrados{0};
+
+// Índice pequeño y estable por hilo (para los registros de época).
+static int id_hilo() {
+    thread_local int id = hilos_registrados.fetch_add(1);
+    if (id >= MAX_HILOS) {
+        cerr << "Error: mas de " << MAX_HILOS << " hilos registrados.\n";
+        std::abort();
+    }
+    return id;
+}
+
+// Reclamación por épocas (EBR): un nodo retirado cuando la época global era e
+// se libera cuando la época llega a e+2, porque para entonces todo hilo que
+// pudiera verlo ya salió de su sección crítica. Una sola publicación por
+// operación, en vez de una barrera por nodo recorrido como con hazard pointers.
+template <class N>
+class Epocas {
+    static constexpr uint64_t ACTIVO = 1;
+    static constexpr int AVANZAR_CADA = 64;   // retiros entre intentos de avanzar
+    struct alignas(64) Registro {
+        std::atomic<uint64_t> local{0};       // (época << 1) | ACTIVO, 0 fuera
+        uint64_t etiqueta[3] = {0, 0, 0};
+        std::vector<N*> limbo[3];
+        int retiros = 0;
+    };
+    std::atomic<uint64_t> global{0};
+    std::unique_ptr<Registro[]> regs{new Registro[MAX_HILOS]};
+
+    static void liberar(std::vector<N*>& v) {
+        for (N* n : v) delete n;
+        v.clear();
+    }
+
+    void intentar_avanzar() {
+        uint64_t e = global.load();
+        int n_hilos = std::min(hilos_registrados.load(), MAX_HILOS);
+        for (int t = 0; t < n_hilos; ++t) {
+            uint64_t v = regs[t].local.load();
+            if ((v & ACTIVO) && (v >> 1) != e) return;
+        }
+        global.compare_exchange_strong(e, e + 1);
+    }
+
+public:
+    ~Epocas() {
+        for (int t = 0; t < MAX_HILOS; ++t)
+            for (auto& v : regs[t].limbo) liberar(v);
+    }
+
+    Registro& entrar() {
+        Registro& r = regs[id_hilo()];
+        uint64_t e;
+        do {
+            e = global.load();
+            r.local.store((e << 1) | ACTIVO);
+        } while (global.load() != e);
+        for (int b = 0; b < 3; ++b)
+            if (!r.limbo[b].empty() && r.etiqueta[b] + 2 <= e) liberar(r.limbo[b]);
+        return r;
+    }
+
+    static void salir(Registro& r) { r.local.store(0, std::memory_order_release); }
+
+    // Llamar dentro de entrar()/salir(), después de desenlazar n.
+    void retirar(Registro& r, N* n) {
+        uint64_t e = global.load();
+        int b = (int)(e % 3);
+        if (r.etiqueta[b] != e) { liberar(r.limbo[b]); r.etiqueta[b] = e; }
+        r.limbo[b].push_back(n);
+        if (++r.retiros % AVANZAR_CADA == 0) intentar_avanzar();
+    }
+};
+
+class ListLockFree : public IList {
+    std::atomic<uintptr_t> head{0};
+    Epocas<LFNode> ebr;
+
+    static bool marcado(uintptr_t p) { return p & 1; }
+    static LFNode* puntero(uintptr_t p) { return reinterpret_cast<LFNode*>(p & ~uintptr_t(1)); }
+    static uintptr_t enlace(LFNode* n) { return reinterpret_cast<uintptr_t>(n); }
+
+    // Busca el primer nodo con key >= key; al volver *prev == cur y next es su
+    // sucesor. Desenlaza (y retira) los nodos marcados que cruza.
+    template <class R>
+    bool buscar(int key, std::atomic<uintptr_t>*& prev, LFNode*& cur, LFNode*& next, R& r) {
+    reintentar:
+        prev = &head;
+        cur = puntero(prev->load(std::memory_order_acquire));
+        while (true) {
+            if (!cur) return false;
+            uintptr_t nx = cur->next.load(std::memory_order_acquire);
+            next = puntero(nx);
+            if (marcado(nx)) {
+                uintptr_t esperado = enlace(cur);
+                if (!prev->compare_exchange_strong(esperado, enlace(next))) goto reintentar;
+                ebr.retirar(r, cur);
+                cur = next;
+            } else {
+                if (cur->key >= key) return cur->key == key;
+                prev = &cur->next;
+                cur = next;
+            }
+        }
+    }
+
+public:
+    ~ListLockFree() override { clear(); }
+
+    bool Member(int key) override {
+        auto& r = ebr.entrar();
+        LFNode* cur = puntero(head.load(std::memory_order_acquire));
+        while (cur && cur->key < key) cur = puntero(cur->next.load(std::memory_order_acquire));
+        bool found = cur && cur->key == key && !marcado(cur->next.load(std::memory_order_acquire));
+        ebr.salir(r);
+        return found;
+    }
+
+    bool Insert(int key) override {
+        auto& r = ebr.entrar();
+        std::atomic<uintptr_t>* prev; LFNode* cur; LFNode* next;
+        LFNode* n = nullptr;
+        bool ok;
+        while (true) {
+            if (buscar(key, prev, cur, next, r)) { ok = false; break; }
+            if (!n) n = new LFNode(key);
+            n->next.store(enlace(cur), std::memory_order_relaxed);
+            uintptr_t esperado = enlace(cur);
+            if (prev->compare_exchange_strong(esperado, enlace(n))) { ok = true; break; }
+        }
+        ebr.salir(r);
+        if (!ok) delete n;
+        return ok;
+    }
+
+    bool Delete(int key) override {
+        auto& r = ebr.entrar();
+        std::atomic<uintptr_t>* prev; LFNode* cur; LFNode* next;
+        bool ok;
+        while (true) {
+            if (!buscar(key, prev, cur, next, r)) { ok = false; break; }
+            // borrado lógico: marcar cur->next
+            uintptr_t nx = enlace(next);
+            if (!cur->next.compare_exchange_strong(nx, nx | 1)) continue;
+            // borrado físico; si falla, buscar() lo desenlaza por nosotros
+            uintptr_t esperado = enlace(cur);
+            if (prev->compare_exchange_strong(esperado, enlace(next))) ebr.retirar(r, cur);
+            else buscar(key, prev, cur, next, r);
+            ok = true; break;
+        }
+        ebr.salir(r);
+        return ok;
+    }
+
+    // Recorrido sin locks: ve cada clave presente durante todo el recorrido;
+    // las insertadas o borradas a la vez pueden aparecer o no.
+    void RangeScan(int lo, int hi, const std::function<void(int)>& visitar) override {
+        auto& r = ebr.entrar();
+        LFNode* cur = puntero(head.load(std::memory_order_acquire));
+        while (cur && cur->key < lo) cur = puntero(cur->next.load(std::memory_order_acquire));
+        for (; cur && cur->key <= hi; cur = puntero(cur->next.load(std::memory_order_acquire)))
+            if (!marcado(cur->next.load(std::memory_order_acquire))) visitar(cur->key);
+        ebr.salir(r);
+    }
+
+    // Sólo sin hilos concurrentes; los retirados los libera ~Epocas.
+    void clear() {
+        LFNode* cur = puntero(head.exchange(0));
+        while (cur) { LFNode* tmp = cur; cur = puntero(cur->next.load()); delete tmp; }
+    }
+};
+
+// --------- nodos con recorrido sin locks (optimistic / lazy) ----------
+// Mismo esquema que FGNode (key, next, mutex por nodo), pero next es atómico
+// para poder recorrer sin locks y hay una marca de borrado lógico (lazy).
+// Se usan centinelas head (INT_MIN) y tail (INT_MAX): nunca hay nullptr.
+struct LZNode : EnPool {
+    int key; std::atomic<LZNode*> next; mutable std::mutex m;
+    std::atomic<bool> marked;
+    explicit LZNode(int k): key(k), next(nullptr), marked(false) {}
+};
+
+class ListLZBase : public IList {
+protected:
+    LZNode* head;
+    Epocas<LZNode> ebr;   // los nodos quitados se liberan por épocas
+
+    // Recorrido sin locks hasta el primer nodo con key >= key.
+    void localizar(int key, LZNode*& pred, LZNode*& cur) const {
+        pred = head;
+        cur = pred->next.load(std::memory_order_acquire);
+        while (cur->key < key) { pred = cur; cur = cur->next.load(std::memory_order_acquire); }
+    }
+
+public:
+    ListLZBase(): head(new LZNode(INT_MIN)) { head->next = new LZNode(INT_MAX); }
+    ~ListLZBase() override { clear(); delete head->next.load(); delete head; }
+
+    // Recorrido sin locks, como Member de lazy (optimistic no marca nodos:
+    // uno recién desenlazado todavía puede visitarse).
+    void RangeScan(int lo, int hi, const std::function<void(int)>& visitar) override {
+        auto& r = ebr.entrar();
+        LZNode *pred, *cur;
+        localizar(lo, pred, cur);
+        for (; cur->key <= hi && cur->key != INT_MAX; cur = cur->next.load(std::memory_order_acquire))
+            if (!cur->marked.load(std::memory_order_acquire)) visitar(cur->key);
+        ebr.salir(r);
+    }
+
+    // Sólo sin hilos concurrentes.
+    void clear() {
+        LZNode* tail = head;
+        while (tail->key != INT_MAX) tail = tail->next.load();
+        LZNode* cur = head->next.load();
+        while (cur != tail) { LZNode* tmp = cur; cur = cur->next.load(); delete tmp; }
+        head->next = tail;
+    }
+};
+
+// --------- 5) optimistic: recorre sin locks, bloquea pred/cur y valida ----------
+class ListOptimistic : public ListLZBase {
+    // pred sigue alcanzable desde head y sigue apuntando a cur
+    bool validar(LZNode* pred, LZNode* cur) const {
+        LZNode* n = head;
+        while (n->key <= pred->key) {
+            if (n == pred) return pred->next.load() == cur;
+            n = n->next.load(std::memory_order_acquire);
+        }
+        return false;
+    }
+
+public:
+    bool Member(int key) override {
+        auto& r = ebr.entrar();
+        bool found;
+        while (true) {
+            LZNode *pred, *cur;
+            localizar(key, pred, cur);
+            std::lock_guard<std::mutex> lp(pred->m), lc(cur->m);
+            if (!validar(pred, cur)) continue;
+            found = (cur->key == key);
+            break;
+        }
+        ebr.salir(r);
+        return found;
+    }
+
+    bool Insert(int key) override {
+        auto& r = ebr.entrar();
+        bool ok;
+        while (true) {
+            LZNode *pred, *cur;
+            localizar(key, pred, cur);
+            std::lock_guard<std::mutex> lp(pred->m), lc(cur->m);
+            if (!validar(pred, cur)) continue;
+            if (cur->key == key) { ok = false; break; }
+            LZNode* n = new LZNode(key);
+            n->next.store(cur, std::memory_order_relaxed);
+            pred->next.store(n, std::memory_order_release);
+            ok = true; break;
+        }
+        ebr.salir(r);
+        return ok;
+    }
+
+    bool Delete(int key) override {
+        auto& r = ebr.entrar();
+        LZNode* quitado = nullptr;
+        while (true) {
+            LZNode *pred, *cur;
+            localizar(key, pred, cur);
+            std::lock_guard<std::mutex> lp(pred->m), lc(cur->m);
+            if (!validar(pred, cur)) continue;
+            if (cur->key != key) break;
+            pred->next.store(cur->next.load(), std::memory_order_release);
+            quitado = cur; break;
+        }
+        if (quitado) ebr.retirar(r, quitado);
+        ebr.salir(r);
+        return quitado != nullptr;
+    }
+};
+
+// --------- 6) lazy: marca lógica + Member sin locks (wait-free) ----------
+class ListLazy : public ListLZBase {
+    // ninguno de los dos fue borrado y siguen enlazados
+    static bool validar(LZNode* pred, LZNode* cur) {
+        return !pred->marked.load() && !cur->marked.load() && pred->next.load() == cur;
+    }
+
+public:
+    bool Member(int key) override {
+        auto& r = ebr.entrar();
+        LZNode *pred, *cur;
+        localizar(key, pred, cur);
+        bool found = (cur->key == key && !cur->marked.load(std::memory_order_acquire));
+        ebr.salir(r);
+        return found;
+    }
+
+    bool Insert(int key) override {
+        auto& r = ebr.entrar();
+        bool ok;
+        while (true) {
+            LZNode *pred, *cur;
+            localizar(key, pred, cur);
+            std::lock_guard<std::mutex> lp(pred->m), lc(cur->m);
+            if (!validar(pred, cur)) continue;
+            if (cur->key == key) { ok = false; break; }
+            LZNode* n = new LZNode(key);
+            n->next.store(cur, std::memory_order_relaxed);
+            pred->next.store(n, std::memory_order_release);
+            ok = true; break;
+        }
+        ebr.salir(r);
+        return ok;
+    }
+
+    bool Delete(int key) override {
+        auto& r = ebr.entrar();
+        LZNode* quitado = nullptr;
+        while (true) {
+            LZNode *pred, *cur;
+            localizar(key, pred, cur);
+            std::lock_guard<std::mutex> lp(pred->m), lc(cur->m);
+            if (!validar(pred, cur)) continue;
+            if (cur->key != key) break;
+            cur->marked.store(true, std::memory_order_release);   // borrado lógico
+            pred->next.store(cur->next.load(), std::memory_order_release);
+            quitado = cur; break;
+        }
+        if (quitado) ebr.retirar(r, quitado);
+        ebr.salir(r);
+        return quitado != nullptr;
+    }
+};
+
+// --------- 7) skiplist: skip list con locks por nodo (lazy skip list) ----------
+// Member recorre sin locks; Insert/Delete bloquean sólo los predecesores de
+// cada nivel y validan como la lista lazy. Los nodos tienen altura variable:
+// next[] se reserva con top+1 entradas al final del propio nodo.
+static constexpr int SKIP_MAX_NIVEL = 24;
+
+struct SkipNode : EnPool {
+    int key; int top;
+    std::atomic<bool> marked{false}, fully_linked{false};
+    mutable std::mutex m;
+    std::atomic<SkipNode*> next[1];   // en realidad top+1 entradas
+
+    static void* operator new(size_t sz, int top) {
+        return pool::reservar(sz + top * sizeof(std::atomic<SkipNode*>));
+    }
+    static void operator delete(void* p) { pool::liberar(p); }
+    static void operator delete(void* p, int) { pool::liberar(p); }
+
+    SkipNode(int k, int t): key(k), top(t) {
+        for (int l = 0; l <= t; ++l) new (&next[l]) std::atomic<SkipNode*>(nullptr);
+    }
+};
+
+class ListSkip : public IList {
+    SkipNode* head;
+    Epocas<SkipNode> ebr;
+
+    // Nivel geométrico (p = 1/2) con un xorshift por hilo.
+    static int nivel_aleatorio() {
+        thread_local uint64_t s = 0x9E3779B97F4A7C15ULL ^ (uint64_t)id_hilo() * 0xBF58476D1CE4E5B9ULL;
+        s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+        return __builtin_ctzll(s | (1ULL << (SKIP_MAX_NIVEL - 1)));
+    }
+
+    // Llena preds/succs por nivel; devuelve el nivel más alto donde está key o -1.
+    int buscar(int key, SkipNode** preds, SkipNode** succs) const {
+        int encontrado = -1;
+        SkipNode* pred = head;
+        for (int l = SKIP_MAX_NIVEL - 1; l >= 0; --l) {
+            SkipNode* cur = pred->next[l].load(std::memory_order_acquire);
+            while (cur->key < key) { pred = cur; cur = pred->next[l].load(std::memory_order_acquire); }
+            if (encontrado == -1 && cur->key == key) encontrado = l;
+            preds[l] = pred; succs[l] = cur;
+        }
+        return encontrado;
+    }
+
+    // Los predecesores pueden repetirse entre niveles: se bloquea cada uno una vez.
+    static void desbloquear(SkipNode** preds, int hasta) {
+        SkipNode* anterior = nullptr;
+        for (int l = 0; l <= hasta; ++l) {
+            if (preds[l] != anterior) preds[l]->m.unlock();
+            anterior = preds[l];
+        }
+    }
+
+public:
+    ListSkip(): head(new (SKIP_MAX_NIVEL - 1) SkipNode(INT_MIN, SKIP_MAX_NIVEL - 1)) {
+        SkipNode* tail = new (SKIP_MAX_NIVEL - 1) SkipNode(INT_MAX, SKIP_MAX_NIVEL - 1);
+        for (int l = 0; l < SKIP_MAX_NIVEL; ++l) head->next[l] = tail;
+    }
+    ~ListSkip() override {
+        SkipNode* cur = head;
+        while (cur) { SkipNode* tmp = cur; cur = cur->next[0].load(); delete tmp; }
+    }
+
+    bool Member(int key) override {
+        auto& r = ebr.entrar();
+        SkipNode* preds[SKIP_MAX_NIVEL]; SkipNode* succs[SKIP_MAX_NIVEL];
+        int l = buscar(key, preds, succs);
+        bool found = l != -1 && succs[l]->fully_linked.load() && !succs[l]->marked.load();
+        ebr.salir(r);
+        return found;
+    }
+
+    bool Insert(int key) override {
+        auto& r = ebr.entrar();
+        int top = nivel_aleatorio();
+        SkipNode* preds[SKIP_MAX_NIVEL]; SkipNode* succs[SKIP_MAX_NIVEL];
+        bool ok;
+        // Con más hilos que núcleos quien borra o enlaza n puede no estar
+        // corriendo: las esperas ceden la CPU como los locks de locks.hpp.
+        locks_detalle::Espera reintento;
+        while (true) {
+            int l = buscar(key, preds, succs);
+            if (l != -1) {
+                SkipNode* n = succs[l];
+                if (n->marked.load()) { reintento(); continue; }   // se está borrando: reintentar
+                locks_detalle::Espera giro;
+                while (!n->fully_linked.load(std::memory_order_acquire)) giro();
+                ok = false; break;
+            }
+            int bloqueado = -1; bool valido = true;
+            SkipNode* anterior = nullptr;
+            for (int lv = 0; valido && lv <= top; ++lv) {
+                SkipNode* pred = preds[lv]; SkipNode* succ = succs[lv];
+                if (pred != anterior) { pred->m.lock(); anterior = pred; }
+                bloqueado = lv;
+                valido = !pred->marked.load() && !succ->marked.load() && pred->next[lv].load() == succ;
+            }
+            if (!valido) { desbloquear(preds, bloqueado); continue; }
+
+            SkipNode* n = new (top) SkipNode(key, top);
+            for (int lv = 0; lv <= top; ++lv) n->next[lv].store(succs[lv], std::memory_order_relaxed);
+            for (int lv = 0; lv <= top; ++lv) preds[lv]->next[lv].store(n, std::memory_order_release);
+            n->fully_linked.store(true);
+            desbloquear(preds, bloqueado);
+            ok = true; break;
+        }
+        ebr.salir(r);
+        return ok;
+    }
+
+    // Una pasada: ultimo[l] es el último nodo enlazado en el nivel l.
+    void CargaMasiva(const std::vector<int>& claves) override {
+        SkipNode* tail = head->next[0].load();
+        SkipNode* ultimo[SKIP_MAX_NIVEL];
+        std::fill(ultimo, ultimo + SKIP_MAX_NIVEL, head);
+        for (int k : claves) {
+            int top = nivel_aleatorio();
+            SkipNode* n = new (top) SkipNode(k, top);
+            for (int l = 0; l <= top; ++l) { ultimo[l]->next[l].store(n, std::memory_order_relaxed); ultimo[l] = n; }
+            n->fully_linked.store(true, std::memory_order_relaxed);
+        }
+        for (int l = 0; l < SKIP_MAX_NIVEL; ++l) ultimo[l]->next[l].store(tail);
+    }
+
+    // Baja por los niveles hasta lo y sigue por el nivel 0 sin locks.
+    void RangeScan(int lo, int hi, const std::function<void(int)>& visitar) override {
+        auto& r = ebr.entrar();
+        SkipNode* preds[SKIP_MAX_NIVEL]; SkipNode* succs[SKIP_MAX_NIVEL];
+        buscar(lo, preds, succs);
+        for (SkipNode* cur = succs[0]; cur->key <= hi && cur->key != INT_MAX;
+             cur = cur->next[0].load(std::memory_order_acquire))
+            if (cur->fully_linked.load() && !cur->marked.load()) visitar(cur->key);
+        ebr.salir(r);
+    }
+
+    bool Delete(int key) override {
+        auto& r = ebr.entrar();
+        SkipNode* preds[SKIP_MAX_NIVEL]; SkipNode* succs[SKIP_MAX_NIVEL];
+        SkipNode* victima = nullptr; bool marcado = false; int top = -1;
+        bool ok;
+        while (true) {
+            int l = buscar(key, preds, succs);
+            if (l != -1) victima = succs[l];
+            if (!marcado && !(l != -1 && victima->fully_linked.load() && victima->top == l
+                              && !victima->marked.load())) { ok = false; break; }
+            if (!marcado) {
+                top = victima->top;
+                victima->m.lock();
+                if (victima->marked.load()) { victima->m.unlock(); ok = false; break; }
+                victima->marked.store(true);   // borrado lógico
+                marcado = true;
+            }
+            int bloqueado = -1; bool valido = true;
+            SkipNode* anterior = nullptr;
+            for (int lv = 0; valido && lv <= top; ++lv) {
+                SkipNode* pred = preds[lv];
+                if (pred != anterior) { pred->m.lock(); anterior = pred; }
+                bloqueado = lv;
+                valido = !pred->marked.load() && pred->next[lv].load() == victima;
+            }
+            if (!valido) { desbloquear(preds, bloqueado); continue; }
+
+            for (int lv = top; lv >= 0; --lv)
+                preds[lv]->next[lv].store(victima->next[lv].load(), std::memory_order_release);
+            victima->m.unlock();
+            desbloquear(preds, bloqueado);
+            ebr.retirar(r, victima);
+            ok = true; break;
+        }
+        ebr.salir(r);
+        return ok;
+    }
+};
+
+// --------- 8) hash: tabla hash con locks por franjas, redimensionable ----------
+// Número fijo de locks; la tabla crece en potencias de dos (múltiplos de
+// FRANJAS), así la cubeta de una clave siempre cae en la misma franja.
+class HashStriped : public IList {
+    static constexpr size_t FRANJAS = 64;
+    static constexpr size_t CARGA_MAX = 4;   // claves por cubeta antes de crecer
+    struct alignas(64) Franja { std::mutex m; };
+
+    std::unique_ptr<Franja[]> franjas{new Franja[FRANJAS]};
+    std::vector<std::vector<int>> tabla;
+    std::atomic<size_t> tam{0};
+
+    static size_t hash(int key) { return (uint32_t)key * 2654435761u; }
+
+    std::vector<int>& cubeta(int key) { return tabla[hash(key) & (tabla.size() - 1)]; }
+
+    void crecer(size_t cap_vista) {
+        std::vector<std::unique_lock<std::mutex>> lks;
+        lks.reserve(FRANJAS);
+        for (size_t i = 0; i < FRANJAS; ++i) lks.emplace_back(franjas[i].m);
+        if (tabla.size() != cap_vista) return;   // otro hilo ya la hizo crecer
+        std::vector<std::vector<int>> nueva(cap_vista * 2);
+        for (auto& c : tabla)
+            for (int k : c) nueva[hash(k) & (nueva.size() - 1)].push_back(k);
+        tabla.swap(nueva);
+    }
+
+public:
+    HashStriped(): tabla(FRANJAS) {}
+
+    bool Member(int key) override {
+        std::lock_guard<std::mutex> lk(franjas[hash(key) % FRANJAS].m);
+        auto& c = cubeta(key);
+        return std::find(c.begin(), c.end(), key) != c.end();
+    }
+
+    bool Insert(int key) override {
+        size_t cap;
+        {
+            std::lock_guard<std::mutex> lk(franjas[hash(key) % FRANJAS].m);
+            auto& c = cubeta(key);
+            if (std::find(c.begin(), c.end(), key) != c.end()) return false;
+            c.push_back(key);
+            cap = tabla.size();
+        }
+        if (tam.fetch_add(1) + 1 > cap * CARGA_MAX) crecer(cap);
+        return true;
+    }
+
+    bool Delete(int key) override {
+        std::lock_guard<std::mutex> lk(franjas[hash(key) % FRANJAS].m);
+        auto& c = cubeta(key);
+        auto it = std::find(c.begin(), c.end(), key);
+        if (it == c.end()) return false;
+        *it = c.back(); c.pop_back();
+        tam.fetch_sub(1);
+        return true;
+    }
+};
+
+// --------- 9) unrolled: cada nodo guarda un arreglo ordenado de claves ----------
+// UNROLL_K claves + cantidad + next = 64 B (una línea de caché; el pool la deja
+// alineada). Mismo esquema de locks que coarse (std::mutex) o rw (lock lector/escritor).
+static constexpr int UNROLL_K = 13;
+
+struct UNode : EnPool {
+    int n = 0; int keys[UNROLL_K]; UNode* next = nullptr;
+};
+static_assert(sizeof(UNode) == 64, "UNode debe ocupar una linea de cache");
+
+template <class M>
+class ListUnrolled : public IList {
+    UNode* head{nullptr};
+    mutable M m;
+    using LockLectura = std::conditional_t<std::is_same_v<M, std::mutex>,
+                                           std::unique_lock<M>, std::shared_lock<M>>;
+
+    // Primer nodo cuya clave máxima es >= key (nullptr si key supera a todas).
+    UNode* localizar(int key, UNode*& pred) const {
+        pred = nullptr; UNode* cur = head;
+        while (cur && cur->keys[cur->n - 1] < key) { pred = cur; cur = cur->next; }
+        return cur;
+    }
+
+    static int posicion(const UNode* u, int key) {
+        return (int)(std::lower_bound(u->keys, u->keys + u->n, key) - u->keys);
+    }
+
+public:
+    ~ListUnrolled() override { clear(); }
+
+    bool Member(int key) override {
+        LockLectura lk(m);
+        UNode* pred;
+        UNode* cur = localizar(key, pred);
+        if (!cur) return false;
+        int i = posicion(cur, key);
+        return i < cur->n && cur->keys[i] == key;
+    }
+
+    bool Insert(int key) override {
+        std::unique_lock<M> lk(m);
+        UNode* pred;
+        UNode* cur = localizar(key, pred);
+        if (!cur) {   // mayor que todas: va al final del último nodo
+            cur = pred;
+            if (!cur) { head = new UNode(); head->keys[head->n++] = key; return true; }
+        }
+        int i = posicion(cur, key);
+        if (i < cur->n && cur->keys[i] == key) return false;
+        if (cur->n == UNROLL_K) {   // lleno: la mitad superior pasa a un nodo nuevo
+            UNode* u = new UNode();
+            int mitad = UNROLL_K / 2;
+            u->n = UNROLL_K - mitad;
+            std::copy(cur->keys + mitad, cur->keys + UNROLL_K, u->keys);
+            cur->n = mitad;
+            u->next = cur->next; cur->next = u;
+            if (i > mitad) { cur = u; i -= mitad; }
+        }
+        std::copy_backward(cur->keys + i, cur->keys + cur->n, cur->keys + cur->n + 1);
+        cur->keys[i] = key; ++cur->n;
+        return true;
+    }
+
+    bool Delete(int key) override {
+        std::unique_lock<M> lk(m);
+        UNode* pred;
+        UNode* cur = localizar(key, pred);
+        if (!cur) return false;
+        int i = posicion(cur, key);
+        if (i >= cur->n || cur->keys[i] != key) return false;
+        std::copy(cur->keys + i + 1, cur->keys + cur->n, cur->keys + i);
+        --cur->n;
+        if (cur->n == 0) {
+            if (!pred) head = cur->next; else pred->next = cur->next;
+            delete cur;
+        } else if (UNode* sig = cur->next; sig && cur->n + sig->n <= UNROLL_K / 2) {
+            // fusiona vecinos poco llenos para no degenerar en una lista simple
+            std::copy(sig->keys, sig->keys + sig->n, cur->keys + cur->n);
+            cur->n += sig->n;
+            cur->next = sig->next;
+            delete sig;
+        }
+        return true;
+    }
+
+    void RangeScan(int lo, int hi, const std::function<void(int)>& visitar) override {
+        LockLectura lk(m);
+        UNode* pred;
+        for (UNode* cur = localizar(lo, pred); cur; cur = cur->next)
+            for (int i = posicion(cur, lo); i < cur->n; ++i) {
+                if (cur->keys[i] > hi) return;
+                visitar(cur->keys[i]);
+            }
+    }
+
+    // Reconstruye la lista en nodos nuevos, reservados seguidos y llenos a 3/4
+    // (deja sitio para inserciones sin partir nodos de inmediato).
+    void Compactar() override {
+        std::unique_lock<M> lk(m);
+        constexpr int RELLENO = UNROLL_K * 3 / 4;
+        UNode* nuevo = nullptr; UNode* ultimo = nullptr;
+        for (UNode* cur = head; cur; cur = cur->next)
+            for (int i = 0; i < cur->n; ++i) {
+                if (!ultimo || ultimo->n == RELLENO) {
+                    UNode* u = new UNode();
+                    if (ultimo) ultimo->next = u; else nuevo = u;
+                    ultimo = u;
+                }
+                ultimo->keys[ultimo->n++] = cur->keys[i];
+            }
+        UNode* cur = head;
+        while (cur) { UNode* tmp = cur; cur = cur->next; delete tmp; }
+        head = nuevo;
+    }
+
+    void clear() {
+        std::unique_lock<M> lk(m);
+        UNode* cur = head;
+        while (cur) { UNode* tmp = cur; cur = cur->next; delete tmp; }
+        head = nullptr;
+    }
+};
+
+// --------- locks lector/escritor alternativos para rw ----------
+// Misma interfaz que std::shared_mutex (lock/unlock, lock_shared/unlock_shared)
+// para usarlos como parámetro de ListRW y ListUnrolled. Se eligen con --rwlock.
+
+// Big-reader: un indicador por hilo, cada uno en su propia línea de caché.
+// Un lector sólo escribe su línea; el escritor levanta su bandera y espera a
+// que todos los indicadores queden en cero (lecturas baratas, escrituras O(hilos)).
+class RWBigReader {
+    struct alignas(64) Indicador { std::atomic<int> activo{0}; };
+    std::unique_ptr<Indicador[]> lectores{new Indicador[MAX_HILOS]};
+    std::atomic<bool> escritor{false};
+    std::mutex escritores;
+public:
+    void lock_shared() {
+        auto& mio = lectores[id_hilo()].activo;
+        while (true) {
+            mio.store(1);                 // seq_cst: se ordena con la lectura de escritor
+            if (!escritor.load()) return;
+            mio.store(0, std::memory_order_relaxed);
+            while (escritor.load(std::memory_order_relaxed)) std::this_thread::yield();
+        }
+    }
+    void unlock_shared() { lectores[id_hilo()].activo.store(0, std::memory_order_release); }
+
+    void lock() {
+        escritores.lock();
+        escritor.store(true);
+        int n_hilos = std::min(hilos_registrados.load(), MAX_HILOS);
+        for (int t = 0; t < n_hilos; ++t)
+            while (lectores[t].activo.load()) std::this_thread::yield();
+    }
+    void unlock() {
+        escritor.store(false, std::memory_order_release);
+        escritores.unlock();
+    }
+};
+
+// Preferencia de escritores: en cuanto hay un escritor esperando, los lectores
+// nuevos se bloquean, así un flujo continuo de Member no deja sin turno a Insert/Delete.
+class RWWriterPref {
+    std::mutex m;
+    std::condition_variable cv_lectores, cv_escritores;
+    int lectores = 0, esperando = 0;
+    bool escribiendo = false;
+public:
+    void lock_shared() {
+        std::unique_lock<std::mutex> lk(m);
+        cv_lectores.wait(lk, [&] { return !escribiendo && esperando == 0; });
+        ++lectores;
+    }
+    void unlock_shared() {
+        std::lock_guard<std::mutex> lk(m);
+        if (--lectores == 0 && esperando) cv_escritores.notify_one();
+    }
+
+    void lock() {
+        std::unique_lock<std::mutex> lk(m);
+        ++esperando;
+        cv_escritores.wait(lk, [&] { return !escribiendo && lectores == 0; });
+        --esperando;
+        escribiendo = true;
+    }
+    void unlock() {
+        std::lock_guard<std::mutex> lk(m);
+        escribiendo = false;
+        if (esperando) cv_escritores.notify_one();
+        else cv_lectores.notify_all();
+    }
+};
+
+// --------- 10) rw con lecturas estilo RCU ----------
+// Los escritores se serializan con un mutex y publican cada cambio con un solo
+// store de puntero; los lectores no toman ningún lock, sólo marcan su época.
+// Los nodos quitados se liberan cuando pasa el período de gracia (Epocas).
+struct RCUNode : EnPool {
+    int key; std::atomic<RCUNode*> next;
+    explicit RCUNode(int k): key(k), next(nullptr) {}
+};
+
+class ListRCU : public IList {
+    std::atomic<RCUNode*> head{nullptr};
+    std::mutex escritores;
+    Epocas<RCUNode> ebr;
+
+    // Sólo con el mutex de escritores tomado.
+    RCUNode* localizar(int key, RCUNode*& pred) const {
+        pred = nullptr;
+        RCUNode* cur = head.load(std::memory_order_relaxed);
+        while (cur && cur->key < key) { pred = cur; cur = cur->next.load(std::memory_order_relaxed); }
+        return cur;
+    }
+    std::atomic<RCUNode*>& enlace(RCUNode* pred) { return pred ? pred->next : head; }
+
+public:
+    ~ListRCU() override { clear(); }
+
+    bool Member(int key) override {
+        auto& r = ebr.entrar();
+        RCUNode* cur = head.load(std::memory_order_acquire);
+        while (cur && cur->key < key) cur = cur->next.load(std::memory_order_acquire);
+        bool found = (cur && cur->key == key);
+        ebr.salir(r);
+        return found;
+    }
+
+    void RangeScan(int lo, int hi, const std::function<void(int)>& visitar) override {
+        auto& r = ebr.entrar();
+        RCUNode* cur = head.load(std::memory_order_acquire);
+        while (cur && cur->key < lo) cur = cur->next.load(std::memory_order_acquire);
+        for (; cur && cur->key <= hi; cur = cur->next.load(std::memory_order_acquire)) visitar(cur->key);
+        ebr.salir(r);
+    }
+
+    bool Insert(int key) override {
+        std::lock_guard<std::mutex> lk(escritores);
+        RCUNode* pred;
+        RCUNode* cur = localizar(key, pred);
+        if (cur && cur->key == key) return false;
+        RCUNode* n = new RCUNode(key);
+        n->next.store(cur, std::memory_order_relaxed);
+        enlace(pred).store(n, std::memory_order_release);
+        return true;
+    }
+
+    bool Delete(int key) override {
+        std::lock_guard<std::mutex> lk(escritores);
+        RCUNode* pred;
+        RCUNode* cur = localizar(key, pred);
+        if (!cur || cur->key != key) return false;
+        enlace(pred).store(cur->next.load(std::memory_order_relaxed), std::memory_order_release);
+        auto& r = ebr.entrar();
+        ebr.retirar(r, cur);
+        ebr.salir(r);
+        return true;
+    }
+
+    // Sólo sin hilos concurrentes.
+    void clear() {
+        RCUNode* cur = head.exchange(nullptr);
+        while (cur) { RCUNode* tmp = cur; cur = cur->next.load(); delete tmp; }
+    }
+};
+
 // --------- helpers ----------
 template <class L>
 static void inicializar_lista(L& list, size_t n, int key_max, std::mt19937& gen) {
@@ -245,35 +1434,173 @@ static void inicializar_lista(L& list, size_t n, int key_max, std::mt19937& gen)
     }
 }
 
+// Carga paralela: n claves distintas en [0, key_max]. Las claves salen en
+// bloques de tamaño fijo con semilla propia (el resultado no depende del
+// número de hilos); cada hilo genera y ordena sus bloques, los tramos se
+// mezclan por pares en paralelo y se quitan repetidas. Se repite con las que
+// falten, como los reintentos de inicializar_lista.
+static std::vector<int> claves_iniciales(size_t n, int key_max, uint64_t seed, int hilos) {
+    constexpr size_t BLOQUE = 1 << 16;
+    n = std::min(n, (size_t)key_max + 1);
+    std::vector<int> claves;
+    for (uint64_t ronda = 0; claves.size() < n && ronda < 50; ++ronda) {
+        size_t falta = n - claves.size();
+        size_t bloques = (falta + BLOQUE - 1) / BLOQUE;
+        std::vector<int> nuevas(falta), buf(falta);
+
+        // tramos contiguos de bloques por hilo, cada uno ordenado
+        std::vector<size_t> lim;
+        std::vector<thread> ths;
+        int h = (int)std::min<size_t>(hilos, bloques);
+        for (int t = 0; t <= h; ++t) lim.push_back(std::min(falta, bloques * t / h * BLOQUE));
+        for (int t = 0; t < h; ++t)
+            ths.emplace_back([&, t] {
+                std::uniform_int_distribution<int> dist(0, key_max);
+                for (size_t b = lim[t]; b < lim[t + 1]; b += BLOQUE) {
+                    std::mt19937 gen(seed ^ (ronda * 0x9E3779B97F4A7C15ULL + b / BLOQUE + 1));
+                    for (size_t i = b; i < std::min(b + BLOQUE, lim[t + 1]); ++i) nuevas[i] = dist(gen);
+                }
+                std::sort(nuevas.begin() + lim[t], nuevas.begin() + lim[t + 1]);
+            });
+        for (auto& th : ths) th.join();
+
+        // mezcla por pares de tramos, un hilo por par
+        while (lim.size() > 2) {
+            std::vector<size_t> sig{0};
+            ths.clear();
+            for (size_t i = 0; i + 1 < lim.size(); i += 2) {
+                size_t a = lim[i], b = lim[i + 1], c = (i + 2 < lim.size()) ? lim[i + 2] : b;
+                ths.emplace_back([&, a, b, c] {
+                    std::merge(nuevas.begin() + a, nuevas.begin() + b, nuevas.begin() + b,
+                               nuevas.begin() + c, buf.begin() + a);
+                });
+                sig.push_back(c);
+            }
+            for (auto& th : ths) th.join();
+            nuevas.swap(buf);
+            lim.swap(sig);
+        }
+
+        std::vector<int> unidas(claves.size() + nuevas.size());
+        std::merge(claves.begin(), claves.end(), nuevas.begin(), nuevas.end(), unidas.begin());
+        unidas.erase(std::unique(unidas.begin(), unidas.end()), unidas.end());
+        claves.swap(unidas);
+    }
+    return claves;
+}
+
 struct Config {
     double p_member, p_insert, p_delete;
     int key_max;
+    uint32_t muestreo;   // mide 1 de cada `muestreo` ops (0: sin latencias)
+    uint32_t lote;       // claves por llamada (1: operaciones simples)
 };
 
+// Compartidos por todos los hilos (--contadores-compartidos): cada operación
+// pega en la misma línea de caché.
 struct Contadores {
     atomic<uint64_t> member_total{0}, insert_total{0}, delete_total{0};
     atomic<uint64_t> member_ok{0},     insert_ok{0},     delete_ok{0};
 };
 
-template <class L>
-void trabajador(L* list, uint64_t ops, Config cfg, uint64_t seed, Contadores* c) {
+// Privados de un hilo, en su propia línea de caché; se suman después del join.
+struct alignas(64) ContadoresHilo {
+    uint64_t member_total = 0, insert_total = 0, delete_total = 0;
+    uint64_t member_ok = 0,    insert_ok = 0,    delete_ok = 0;
+};
+
+struct alignas(64) Latencias {
+    Histograma member, insert, del;
+};
+
+// Con --lote=B cada iteración elige una operación y la aplica a B claves
+// ordenadas con *Batch; las latencias son por lote.
+template <class L, class C>
+void trabajador_lotes(L* list, uint64_t ops, Config cfg, uint64_t seed, C* c, Latencias* lat) {
+    using reloj = std::chrono::steady_clock;
     std::mt19937 rng(seed);
     std::uniform_real_distribution<double> pick(0.0,1.0);
     std::uniform_int_distribution<int> keys(0, cfg.key_max);
+    std::vector<int> lote(cfg.lote);
+    uint32_t faltan = cfg.muestreo;
+
+    for (uint64_t i = 0; i < ops; i += lote.size()) {
+        lote.resize(std::min<uint64_t>(cfg.lote, ops - i));
+        double r = pick(rng);
+        for (int& k : lote) k = keys(rng);
+        std::sort(lote.begin(), lote.end());
+        bool medir = cfg.muestreo && --faltan == 0;
+        reloj::time_point t0;
+        if (medir) { faltan = cfg.muestreo; t0 = reloj::now(); }
+        Histograma* h;
+        if (r < cfg.p_member) {
+            c->member_total += lote.size(); c->member_ok += list->MemberBatch(lote.data(), lote.size());
+            h = &lat->member;
+        } else if (r < cfg.p_member + cfg.p_insert) {
+            c->insert_total += lote.size(); c->insert_ok += list->InsertBatch(lote.data(), lote.size());
+            h = &lat->insert;
+        } else {
+            c->delete_total += lote.size(); c->delete_ok += list->DeleteBatch(lote.data(), lote.size());
+            h = &lat->del;
+        }
+        if (medir)
+            h->registrar(std::chrono::duration_cast<std::chrono::nanoseconds>(reloj::now() - t0).count());
+    }
+}
+
+template <class L, class C>
+void trabajador(L* list, uint64_t ops, Config cfg, uint64_t seed, C* c, Latencias* lat) {
+    if (cfg.lote > 1) { trabajador_lotes(list, ops, cfg, seed, c, lat); return; }
+    using reloj = std::chrono::steady_clock;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> pick(0.0,1.0);
+    std::uniform_int_distribution<int> keys(0, cfg.key_max);
+    uint32_t faltan = cfg.muestreo;   // ops hasta la próxima medición
 
     for (uint64_t i = 0; i < ops; ++i) {
         double r = pick(rng);
         int k = keys(rng);
+        bool medir = cfg.muestreo && --faltan == 0;
+        reloj::time_point t0;
+        if (medir) { faltan = cfg.muestreo; t0 = reloj::now(); }
+        Histograma* h;
         if (r < cfg.p_member) {
             c->member_total++; if (list->Member(k)) c->member_ok++;
+            h = &lat->member;
         } else if (r < cfg.p_member + cfg.p_insert) {
             c->insert_total++; if (list->Insert(k)) c->insert_ok++;
+            h = &lat->insert;
         } else {
             c->delete_total++; if (list->Delete(k)) c->delete_ok++;
+            h = &lat->del;
         }
+        if (medir)
+            h->registrar(std::chrono::duration_cast<std::chrono::nanoseconds>(reloj::now() - t0).count());
     }
 }
 
+// Instancia L con el lock lector/escritor pedido en --rwlock.
+template <template <class> class L>
+static unique_ptr<IList> con_rwlock(const string& tipo) {
+    if (tipo == "std") return make_unique<L<std::shared_mutex>>();
+    if (tipo == "bigreader") return make_unique<L<RWBigReader>>();
+    if (tipo == "writerpref") return make_unique<L<RWWriterPref>>();
+    return nullptr;
+}
+
+// Instancia L con el lock pedido en --lock.
+template <template <class> class L>
+static unique_ptr<IList> con_lock(const string& tipo) {
+    if (tipo == "std") return make_unique<L<std::mutex>>();
+    if (tipo == "tas") return make_unique<L<LockTAS>>();
+    if (tipo == "ttas") return make_unique<L<LockTTAS>>();
+    if (tipo == "ticket") return make_unique<L<LockTicket>>();
+    if (tipo == "mcs") return make_unique<L<LockMCS>>();
+    if (tipo == "clh") return make_unique<L<LockCLH>>();
+    if (tipo == "hibrido") return make_unique<L<LockHibrido>>();
+    return nullptr;
+}
+
 // --------- main ----------
 int main(int argc, char** argv) {
     ios::sync_with_stdio(false);
@@ -281,8 +1608,18 @@ int main(int argc, char** argv) {
 
     if (argc < 10) {
         cerr << "Uso:\n"
-             << "  " << argv[0] << " <strategy> <threads> <ops_por_thread> <member_pct> <insert_pct> <delete_pct> <init_n> <key_max> <seed>\n"
-             << "  strategy: coarse | fine | rw\n";
+             << "  " << argv[0] << " <strategy> <threads> <ops_por_thread> <member_pct> <insert_pct> <delete_pct> <init_n> <key_max> <seed> [opciones]\n"
+             << "  strategy: coarse | fine | rw | lockfree | optimistic | lazy | skiplist | hash | unrolled | unrolled-rw\n"
+             << "  opciones:\n"
+             << "    --sin-pool       nodos con new/delete en vez del pool por hilo\n"
+             << "    --sin-compactar  no reorganiza los nodos tras la carga inicial\n"
+             << "    --rwlock=<tipo>  std | bigreader | writerpref | rcu (rw, unrolled-rw)\n"
+             << "    --lock=<tipo>    std | tas | ttas | ticket | mcs | clh | hibrido (coarse, fine)\n"
+             << "    --contadores-compartidos  contadores atomicos comunes a todos los hilos\n"
+             << "    --muestreo=N     latencia de 1 de cada N ops (8; 0 = no mide)\n"
+             << "    --formato=<f>    texto | csv | json\n"
+             << "    --lote=B         operaciones en lotes de B claves ordenadas\n"
+             << "    --carga-paralela[=H]  carga inicial masiva con H hilos\n";
         return 1;
     }
 
@@ -296,6 +1633,45 @@ int main(int argc, char** argv) {
     int key_max      = stoi(argv[8]);
     uint64_t seed    = stoull(argv[9]);
 
+    bool compactar = true;
+    string rwlock = "std";
+    string lock = "std";
+    bool contadores_compartidos = false;
+    // Se leen en 64 bits y se validan antes de pasar a los uint32_t de Config.
+    uint64_t muestreo = 8;
+    uint64_t lote = 1;
+    int hilos_carga = 0;   // 0: carga secuencial con Insert
+    string formato = "texto";
+    for (int a = 10; a < argc; ++a) {
+        string op = argv[a];
+        if (op == "--sin-pool") pool::activo = false;
+        else if (op == "--sin-compactar") compactar = false;
+        else if (op.rfind("--rwlock=", 0) == 0) rwlock = op.substr(9);
+        else if (op.rfind("--lock=", 0) == 0) lock = op.substr(7);
+        else if (op == "--contadores-compartidos") contadores_compartidos = true;
+        else if (op.rfind("--muestreo=", 0) == 0) muestreo = stoull(op.substr(11));
+        else if (op.rfind("--formato=", 0) == 0) formato = op.substr(10);
+        else if (op.rfind("--lote=", 0) == 0) lote = std::max<uint64_t>(1, stoull(op.substr(7)));
+        else if (op == "--carga-paralela") hilos_carga = std::max(1u, std::thread::hardware_concurrency());
+        else if (op.rfind("--carga-paralela=", 0) == 0) hilos_carga = std::max(1, stoi(op.substr(17)));
+        else { cerr << "Opcion desconocida: " << op << "\n"; return 1; }
+    }
+    if (muestreo > UINT32_MAX) {
+        cerr << "--muestreo debe ser <= " << UINT32_MAX << "\n";
+        return 1;
+    }
+    // Cada hilo guarda el lote en un vector; más de un millón de claves por
+    // llamada no tiene sentido para una lista.
+    const uint64_t LOTE_MAX = 1u << 20;
+    if (lote > LOTE_MAX) {
+        cerr << "--lote debe ser <= " << LOTE_MAX << "\n";
+        return 1;
+    }
+    if (formato != "texto" && formato != "csv" && formato != "json") {
+        cerr << "Formato desconocido: " << formato << "\n";
+        return 1;
+    }
+
     if (fabs(m_pct + i_pct + d_pct - 100.0) > 1e-6) {
         cerr << "Error: los porcentajes deben sumar 100.\n";
         return 2;
@@ -306,40 +1682,141 @@ int main(int argc, char** argv) {
     cfg.p_insert = i_pct / 100.0;
     cfg.p_delete = d_pct / 100.0;
     cfg.key_max  = key_max;
+    cfg.muestreo = (uint32_t)muestreo;
+    cfg.lote     = (uint32_t)lote;
 
     unique_ptr<IList> list;
-    if (strategy == "coarse") list = make_unique<ListCoarse>();
-    else if (strategy == "fine") list = make_unique<ListFine>();
-    else if (strategy == "rw") list = make_unique<ListRW>();
+    if (strategy == "coarse") list = con_lock<ListCoarse>(lock);
+    else if (strategy == "fine") list = con_lock<ListFine>(lock);
+    else if (strategy == "rw" && rwlock == "rcu") list = make_unique<ListRCU>();
+    else if (strategy == "rw") list = con_rwlock<ListRW>(rwlock);
+    else if (strategy == "lockfree") list = make_unique<ListLockFree>();
+    else if (strategy == "optimistic") list = make_unique<ListOptimistic>();
+    else if (strategy == "lazy") list = make_unique<ListLazy>();
+    else if (strategy == "skiplist") list = make_unique<ListSkip>();
+    else if (strategy == "hash") list = make_unique<HashStriped>();
+    else if (strategy == "unrolled") list = make_unique<ListUnrolled<std::mutex>>();
+    else if (strategy == "unrolled-rw") list = con_rwlock<ListUnrolled>(rwlock);
     else { cerr << "Estrategia desconocida.\n"; return 3; }
+    if (!list && (strategy == "coarse" || strategy == "fine")) { cerr << "Lock desconocido: " << lock << "\n"; return 3; }
+    if (!list) { cerr << "Lock lector/escritor desconocido para " << strategy << ": " << rwlock << "\n"; return 3; }
 
     std::mt19937 gen(seed);
-    inicializar_lista(*list, init_n, key_max, gen);
+    Timer TC; TC.start();
+    if (hilos_carga > 0) list->CargaMasiva(claves_iniciales(init_n, key_max, seed, hilos_carga));
+    else inicializar_lista(*list, init_n, key_max, gen);
+    if (compactar) list->Compactar();
+    double ms_carga = TC.stop_ms();
 
     vector<thread> pool;
     Contadores cont;
+    vector<ContadoresHilo> locales(threads);
+    vector<Latencias> lats(threads);
     Timer T; T.start();
 
     for (int t = 0; t < threads; ++t) {
         uint64_t s = seed + 101ULL * (t+1);
-        pool.emplace_back(trabajador<IList>, list.get(), ops_pt, cfg, s, &cont);
+        if (contadores_compartidos)
+            pool.emplace_back(trabajador<IList, Contadores>, list.get(), ops_pt, cfg, s, &cont, &lats[t]);
+        else
+            pool.emplace_back(trabajador<IList, ContadoresHilo>, list.get(), ops_pt, cfg, s, &locales[t], &lats[t]);
     }
     for (auto& th : pool) th.join();
 
     double ms = T.stop_ms();
+    for (const auto& l : locales) {
+        cont.member_total += l.member_total; cont.member_ok += l.member_ok;
+        cont.insert_total += l.insert_total; cont.insert_ok += l.insert_ok;
+        cont.delete_total += l.delete_total; cont.delete_ok += l.delete_ok;
+    }
+    Latencias lat;
+    for (const auto& l : lats) {
+        lat.member.sumar(l.member); lat.insert.sumar(l.insert); lat.del.sumar(l.del);
+    }
     uint64_t total_ops = ops_pt * (uint64_t)threads;
+    double ops_s = total_ops / (ms / 1000.0);
+
+    string nombre = strategy;
+    if (rwlock != "std" && (strategy == "rw" || strategy == "unrolled-rw")) nombre += "/" + rwlock;
+    if (lock != "std" && (strategy == "coarse" || strategy == "fine")) nombre += "/" + lock;
+    pool::Estadisticas pe = pool::estadisticas();
+    size_t tam_final = 0;
+    list->RangeScan(0, key_max, [&](int) { ++tam_final; });
+
+    struct FilaOp { const char* op; uint64_t total, ok; const Histograma* h; };
+    const FilaOp filas[] = {
+        { "Member", cont.member_total.load(), cont.member_ok.load(), &lat.member },
+        { "Insert", cont.insert_total.load(), cont.insert_ok.load(), &lat.insert },
+        { "Delete", cont.delete_total.load(), cont.delete_ok.load(), &lat.del },
+    };
+    const double PERCENTILES[] = { 50, 90, 99, 99.9 };
+
+    if (formato == "csv") {
+        cout << "strategy,threads,ops_por_hilo,member_pct,insert_pct,delete_pct,init_n,key_max,seed,"
+                "lote,carga_s,tiempo_s,ops_s,tam_final,op,total,ok,muestras,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n";
+        for (const auto& f : filas) {
+            cout << nombre << "," << threads << "," << ops_pt << "," << m_pct << "," << i_pct << ","
+                 << d_pct << "," << init_n << "," << key_max << "," << seed << ","
+                 << lote << "," << ms_carga / 1000.0 << "," << ms / 1000.0 << "," << ops_s << "," << tam_final << "," << f.op << "," << f.total << "," << f.ok << ","
+                 << f.h->n;
+            for (double p : PERCENTILES) cout << "," << f.h->percentil(p);
+            cout << "," << f.h->max << "\n";
+        }
+        return 0;
+    }
+    if (formato == "json") {
+        cout << "{\"strategy\": \"" << nombre << "\", \"threads\": " << threads
+             << ", \"ops_por_hilo\": " << ops_pt
+             << ", \"mix\": {\"member\": " << m_pct << ", \"insert\": " << i_pct << ", \"delete\": " << d_pct << "}"
+             << ", \"init_n\": " << init_n << ", \"key_max\": " << key_max << ", \"seed\": " << seed
+             << ", \"lote\": " << lote << ", \"carga_s\": " << ms_carga / 1000.0 << ", \"tiempo_s\": " << ms / 1000.0 << ", \"ops_s\": " << ops_s
+             << ", \"tam_final\": " << tam_final << ", \"muestreo\": " << cfg.muestreo
+             << ", \"asignaciones\": {\"pool\": " << (pool::activo ? "true" : "false")
+             << ", \"reservas\": " << pe.reservas << ", \"liberaciones\": " << pe.liberaciones
+             << ", \"slabs\": " << pe.slabs << "}, \"ops\": {";
+        for (size_t i = 0; i < 3; ++i) {
+            const auto& f = filas[i];
+            cout << (i ? ", " : "") << "\"" << f.op << "\": {\"total\": " << f.total << ", \"ok\": " << f.ok
+                 << ", \"muestras\": " << f.h->n << ", \"p50_ns\": " << f.h->percentil(50)
+                 << ", \"p90_ns\": " << f.h->percentil(90) << ", \"p99_ns\": " << f.h->percentil(99)
+                 << ", \"p999_ns\": " << f.h->percentil(99.9) << ", \"max_ns\": " << f.h->max << "}";
+        }
+        cout << "}}\n";
+        return 0;
+    }
 
     cout << fixed << setprecision(3);
-    cout << "=== Lista enlazada multithread (" << strategy << ") ===\n";
+    cout << "=== Lista enlazada multithread (" << nombre << ") ===\n";
     cout << "Hilos: " << threads << ", Ops por hilo: " << ops_pt
          << " (Total: " << total_ops << ")\n";
     cout << "Mix: Member " << m_pct << "%, Insert " << i_pct << "%, Delete " << d_pct << "%\n";
     cout << "Init N: " << init_n << ", KeyMax: " << key_max << ", Seed: " << seed << "\n";
+    cout << "Carga inicial: " << (ms_carga/1000.0) << " s"
+         << (hilos_carga ? " (paralela, " + to_string(hilos_carga) + " hilos)" : string(" (secuencial)")) << "\n";
     cout << "Tiempo total: " << (ms/1000.0) << " s\n";
     cout << "Resultados: "
          << "Member " << cont.member_ok.load() << "/" << cont.member_total.load() << ", "
          << "Insert " << cont.insert_ok.load() << "/" << cont.insert_total.load() << ", "
          << "Delete " << cont.delete_ok.load() << "/" << cont.delete_total.load() << "\n";
+    cout << "Asignaciones (" << (pool::activo ? "pool" : "new/delete") << "): "
+         << "reservas " << pe.reservas << ", liberaciones " << pe.liberaciones
+         << ", slabs " << pe.slabs << "\n";
+    cout << "Tamano final: " << tam_final << " claves\n";
+    cout << "Throughput: " << ops_s << " ops/s\n";
+    if (cfg.muestreo) {
+        if (lote > 1)
+            cout << "Latencia (ns por lote de " << lote << ", 1 de cada " << cfg.muestreo << " lotes):\n";
+        else
+            cout << "Latencia (ns, 1 de cada " << cfg.muestreo << " ops):\n";
+        for (const auto& f : filas) {
+            cout << "  " << f.op << ": n=" << f.h->n;
+            if (f.h->n)
+                cout << " p50=" << f.h->percentil(50) << " p90=" << f.h->percentil(90)
+                     << " p99=" << f.h->percentil(99) << " p99.9=" << f.h->percentil(99.9)
+                     << " max=" << f.h->max;
+            cout << "\n";
+        }
+    }
 
     return 0;
 }
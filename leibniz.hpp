@@ -0,0 +1,188 @@
+/*
+ * Kernels de la serie de Leibniz  π/4 = 1 - 1/3 + 1/5 - 1/7 + ...
+ * Compartido por secuencial.cpp y pi_mt.cpp.
+ *
+ * Todos calculan la suma de los términos i en [first, last):
+ *   escalar      referencia: el bucle original con i % 2 y una división por término
+ *   pares        sin rama: junta los términos 2k y 2k+1,
+ *                1/(4k+1) - 1/(4k+3) = 2 / ((4k+1)(4k+3)), una división cada dos
+ *   avx2         pares en 4 lanes double y 4 acumuladores (suma compensada)
+ *   avx2-rcp     igual, con recíproco aproximado (rcp_ps) y 3 pasos de Newton
+ *   avx512       pares en 8 lanes double y 4 acumuladores (suma compensada)
+ *   avx512-rcp   igual, con rcp14_pd y 2 pasos de Newton
+ * Los vectoriales se compilan con __attribute__((target)) y se eligen en
+ * tiempo de ejecución según la CPU; no hace falta -mavx2 al compilar.
+ */
+
+#ifndef LEIBNIZ_HPP
+#define LEIBNIZ_HPP
+
+#include <immintrin.h>
+#include <string>
+#include <vector>
+
+typedef double (*KernelLeibniz)(long long first, long long last);
+
+inline double leibniz_escalar(long long first, long long last) {
+    double sum = 0.0;
+    for (long long i = first; i < last; i++) {
+        double factor = (i % 2 == 0) ? 1.0 : -1.0;
+        sum += factor / (2 * i + 1);
+    }
+    return sum;
+}
+
+// Deja el rango en pares completos (first par, longitud par) sumando aparte
+// el término impar inicial y el par final si sobran. Devuelve esa suma.
+inline double leibniz_bordes(long long& first, long long& last) {
+    double sum = 0.0;
+    if (first < last && (first & 1)) { sum -= 1.0 / (2 * first + 1); first++; }
+    if (first < last && ((last - first) & 1)) { last--; sum += 1.0 / (2 * last + 1); }
+    return sum;
+}
+
+// Pares k en [k0, k1): sum 2 / ((4k+1)(4k+3)).
+// Los términos de pares son todos positivos y decaen como 1/(8k²): con suma
+// simple, pasado k ~ 5e7 quedan por debajo de medio ulp del acumulador y se
+// pierden. Por eso se usa suma compensada (Kahan), en escalar y en los lanes.
+inline double leibniz_pares_rango(long long k0, long long k1) {
+    double sum = 0.0, c = 0.0;
+    for (long long k = k0; k < k1; k++) {
+        double d = 4.0 * k + 1.0;
+        double y = 2.0 / (d * (d + 2.0)) - c;
+        double t = sum + y;
+        c = (t - sum) - y;
+        sum = t;
+    }
+    return sum;
+}
+
+inline double leibniz_pares(long long first, long long last) {
+    double sum = leibniz_bordes(first, last);
+    return sum + leibniz_pares_rango(first / 2, last / 2);
+}
+
+template <bool RCP>
+__attribute__((target("avx2,fma")))
+double leibniz_avx2(long long first, long long last) {
+    double borde = leibniz_bordes(first, last);
+    long long k = first / 2, k1 = last / 2;
+    const __m256d dos = _mm256_set1_pd(2.0), uno = _mm256_set1_pd(1.0);
+    __m256d d[4], acc[4], comp[4];
+    for (int a = 0; a < 4; a++) {
+        double b = 4.0 * (k + 4 * a) + 1.0;
+        d[a] = _mm256_setr_pd(b, b + 4.0, b + 8.0, b + 12.0);
+        acc[a] = comp[a] = _mm256_setzero_pd();
+    }
+    const __m256d salto = _mm256_set1_pd(64.0);    // 4 acumuladores x 4 lanes x 4
+    for (; k + 16 <= k1; k += 16) {
+        #pragma GCC unroll 4
+        for (int a = 0; a < 4; a++) {
+            __m256d p = _mm256_mul_pd(d[a], _mm256_add_pd(d[a], dos));
+            __m256d t;
+            if (RCP) {
+                // rcp_ps da ~12 bits; cada Newton duplica: 12 -> 24 -> 48 -> 53
+                __m256d x = _mm256_cvtps_pd(_mm_rcp_ps(_mm256_cvtpd_ps(p)));
+                #pragma GCC unroll 3
+                for (int it = 0; it < 3; it++)
+                    x = _mm256_fmadd_pd(x, _mm256_fnmadd_pd(p, x, uno), x);
+                t = _mm256_mul_pd(dos, x);
+            } else {
+                t = _mm256_div_pd(dos, p);
+            }
+            __m256d y = _mm256_sub_pd(t, comp[a]);
+            __m256d nuevo = _mm256_add_pd(acc[a], y);
+            comp[a] = _mm256_sub_pd(_mm256_sub_pd(nuevo, acc[a]), y);
+            acc[a] = nuevo;
+            d[a] = _mm256_add_pd(d[a], salto);
+        }
+    }
+    // Las correcciones pendientes se restan antes de juntar los lanes.
+    double l[4][4], sum = 0.0;
+    for (int a = 0; a < 4; a++)
+        _mm256_storeu_pd(l[a], _mm256_sub_pd(acc[a], comp[a]));
+    for (int j = 0; j < 4; j++)
+        sum += (l[0][j] + l[1][j]) + (l[2][j] + l[3][j]);
+    return borde + sum + leibniz_pares_rango(k, k1);
+}
+
+template <bool RCP>
+__attribute__((target("avx512f")))
+double leibniz_avx512(long long first, long long last) {
+    double borde = leibniz_bordes(first, last);
+    long long k = first / 2, k1 = last / 2;
+    const __m512d dos = _mm512_set1_pd(2.0), uno = _mm512_set1_pd(1.0);
+    const __m512d lanes = _mm512_setr_pd(0, 4, 8, 12, 16, 20, 24, 28);
+    __m512d d[4], acc[4], comp[4];
+    for (int a = 0; a < 4; a++) {
+        d[a] = _mm512_add_pd(_mm512_set1_pd(4.0 * (k + 8 * a) + 1.0), lanes);
+        acc[a] = comp[a] = _mm512_setzero_pd();
+    }
+    const __m512d salto = _mm512_set1_pd(128.0);   // 4 acumuladores x 8 lanes x 4
+    for (; k + 32 <= k1; k += 32) {
+        #pragma GCC unroll 4
+        for (int a = 0; a < 4; a++) {
+            __m512d p = _mm512_mul_pd(d[a], _mm512_add_pd(d[a], dos));
+            __m512d t;
+            if (RCP) {
+                // rcp14 da 14 bits (forma maskz para evitar el aviso de
+                // -Wmaybe-uninitialized de GCC 12): 14 -> 28 -> 56
+                __m512d x = _mm512_maskz_rcp14_pd(0xFF, p);
+                #pragma GCC unroll 3
+                for (int it = 0; it < 2; it++)
+                    x = _mm512_fmadd_pd(x, _mm512_fnmadd_pd(p, x, uno), x);
+                t = _mm512_mul_pd(dos, x);
+            } else {
+                t = _mm512_div_pd(dos, p);
+            }
+            __m512d y = _mm512_sub_pd(t, comp[a]);
+            __m512d nuevo = _mm512_add_pd(acc[a], y);
+            comp[a] = _mm512_sub_pd(_mm512_sub_pd(nuevo, acc[a]), y);
+            acc[a] = nuevo;
+            d[a] = _mm512_add_pd(d[a], salto);
+        }
+    }
+    double l[4][8], sum = 0.0;
+    for (int a = 0; a < 4; a++)
+        _mm512_storeu_pd(l[a], _mm512_sub_pd(acc[a], comp[a]));
+    for (int j = 0; j < 8; j++)
+        sum += (l[0][j] + l[1][j]) + (l[2][j] + l[3][j]);
+    return borde + sum + leibniz_pares_rango(k, k1);
+}
+
+struct InfoLeibniz {
+    const char* nombre;
+    KernelLeibniz f;
+};
+
+// Kernels que la CPU actual puede ejecutar, del más simple al más ancho.
+inline std::vector<InfoLeibniz> kernels_leibniz() {
+    std::vector<InfoLeibniz> v = {{"escalar", leibniz_escalar}, {"pares", leibniz_pares}};
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        v.push_back({"avx2", leibniz_avx2<false>});
+        v.push_back({"avx2-rcp", leibniz_avx2<true>});
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        v.push_back({"avx512", leibniz_avx512<false>});
+        v.push_back({"avx512-rcp", leibniz_avx512<true>});
+    }
+    return v;
+}
+
+// "auto" elige el vectorial exacto más ancho disponible. Si el nombre no
+// existe o la CPU no lo soporta devuelve {nullptr, nullptr}.
+inline InfoLeibniz elegir_leibniz(const std::string& nombre) {
+    std::vector<InfoLeibniz> v = kernels_leibniz();
+    if (nombre == "auto") {
+        InfoLeibniz mejor = v[1];
+        for (const InfoLeibniz& k : v)
+            if (std::string(k.nombre) == "avx2" || std::string(k.nombre) == "avx512") mejor = k;
+        return mejor;
+    }
+    for (const InfoLeibniz& k : v)
+        if (nombre == k.nombre) return k;
+    return {nullptr, nullptr};
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*
+ * Microbenchmark de locks (locks.hpp) frente a std::mutex
+ *
+ * Compilar: g++ -O2 -std=c++17 -Wall -o lock_bench lock_bench.cpp -lpthread
+ * Ejecutar: ./lock_bench <lock> <max_hilos> [opciones]
+ *   lock: std | tas | ttas | ticket | mcs | clh | hibrido | todos
+ *   Recorre 1, 2, 4, ... hasta max_hilos (incluido) y para cada cantidad mide:
+ *     rendimiento  cada hilo hace --ops adquisiciones seguidas de un contador
+ *                  compartido: Mops/s totales y ns por adquisición
+ *     relevo       el lock tiene que pasar de un hilo al siguiente en orden
+ *                  (turno = (turno + 1) % hilos): ns por cada traspaso, que
+ *                  incluye despertar o avisar al que espera
+ *   opciones:
+ *     --ops=N        adquisiciones por hilo (por defecto 1000000)
+ *     --relevos=N    traspasos a medir en relevo (por defecto 100000)
+ *     --dentro=P     pausas (_mm_pause) dentro de la sección crítica (0)
+ *     --fuera=P      pausas entre adquisiciones, trabajo no crítico (0)
+ *     --formato=<f>  texto (por defecto) | csv
+ *   Con más hilos que núcleos los locks FIFO (ticket, mcs, clh) se degradan
+ *   mucho: cada traspaso espera a que el siguiente de la cola vuelva a correr.
+ * Ejemplo:   ./lock_bench todos 8
+ *            ./lock_bench mcs 16 --dentro=20 --fuera=200 --formato=csv
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <immintrin.h>
+#include "locks.hpp"
+
+using namespace std;
+using namespace chrono;
+
+struct Opciones {
+    long ops = 1000000;
+    long relevos = 100000;
+    int dentro = 0, fuera = 0;
+    string formato = "texto";
+};
+
+struct Resultado {
+    double mops_s, ns_adquisicion, ns_relevo;
+    bool correcto;
+};
+
+inline void pausas(int p) {
+    for (int i = 0; i < p; i++) _mm_pause();
+}
+
+// Lanza h hilos que esperan juntos en una barrera antes de correr f(id);
+// devuelve el tiempo desde que se abre la barrera hasta el último join.
+static double correr_hilos(int h, const function<void(int)>& f) {
+    atomic<int> listos(0);
+    atomic<bool> salida(false);
+    vector<thread> hilos;
+    for (int id = 0; id < h; id++)
+        hilos.emplace_back([&, id] {
+            listos.fetch_add(1);
+            while (!salida.load(memory_order_acquire)) this_thread::yield();
+            f(id);
+        });
+    while (listos.load() < h) this_thread::yield();
+    auto t0 = steady_clock::now();
+    salida.store(true, memory_order_release);
+    for (auto& t : hilos) t.join();
+    return duration<double>(steady_clock::now() - t0).count();
+}
+
+template <class L>
+Resultado medir(int h, const Opciones& op) {
+    Resultado r;
+
+    // Rendimiento: todos compiten por el mismo contador.
+    {
+        L lock;
+        long contador = 0;
+        double s = correr_hilos(h, [&](int) {
+            for (long i = 0; i < op.ops; i++) {
+                lock.lock();
+                contador++;
+                pausas(op.dentro);
+                lock.unlock();
+                pausas(op.fuera);
+            }
+        });
+        long total = op.ops * h;
+        r.mops_s = total / s / 1e6;
+        r.ns_adquisicion = s * 1e9 / total;
+        r.correcto = (contador == total);
+    }
+
+    // Relevo: sólo el hilo de turno avanza; los demás entran, ven que no es
+    // su turno y sueltan. Con un hilo es solamente lock + unlock. Si hay más
+    // hilos que núcleos, el que no tiene turno cede la CPU: con un lock no
+    // FIFO podría volver a tomarlo hasta agotar su quantum sin que el de
+    // turno llegue a correr.
+    {
+        L lock;
+        long hechos = 0;
+        int turno = 0;
+        bool ceder = h > (int) thread::hardware_concurrency();
+        double s = correr_hilos(h, [&](int id) {
+            while (true) {
+                lock.lock();
+                bool fin = hechos >= op.relevos, mio = turno == id;
+                if (!fin && mio) {
+                    turno = (turno + 1) % h;
+                    hechos++;
+                }
+                lock.unlock();
+                if (fin) return;
+                if (!mio && ceder) this_thread::yield();
+            }
+        });
+        r.ns_relevo = s * 1e9 / op.relevos;
+    }
+    return r;
+}
+
+typedef Resultado (*Medidor)(int, const Opciones&);
+
+struct InfoLock {
+    const char* nombre;
+    Medidor f;
+};
+
+static const InfoLock LOCKS[] = {
+    {"std",     medir<std::mutex>},
+    {"tas",     medir<LockTAS>},
+    {"ttas",    medir<LockTTAS>},
+    {"ticket",  medir<LockTicket>},
+    {"mcs",     medir<LockMCS>},
+    {"clh",     medir<LockCLH>},
+    {"hibrido", medir<LockHibrido>},
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Uso: " << argv[0] << " <lock> <max_hilos> [--ops=N] [--relevos=N] [--dentro=P] [--fuera=P] [--formato=texto|csv]\n"
+             << "  lock: std | tas | ttas | ticket | mcs | clh | hibrido | todos\n";
+        return 1;
+    }
+
+    string nombre = argv[1];
+    int max_hilos = atoi(argv[2]);
+    Opciones op;
+    for (int a = 3; a < argc; a++) {
+        string s = argv[a];
+        if (s.rfind("--ops=", 0) == 0) op.ops = atol(s.c_str() + 6);
+        else if (s.rfind("--relevos=", 0) == 0) op.relevos = atol(s.c_str() + 10);
+        else if (s.rfind("--dentro=", 0) == 0) op.dentro = atoi(s.c_str() + 9);
+        else if (s.rfind("--fuera=", 0) == 0) op.fuera = atoi(s.c_str() + 8);
+        else if (s.rfind("--formato=", 0) == 0) op.formato = s.substr(10);
+        else { cerr << "Opción desconocida: " << s << "\n"; return 1; }
+    }
+    if (max_hilos < 1 || op.ops < 1 || op.relevos < 1 || (op.formato != "texto" && op.formato != "csv")) {
+        cerr << "Argumentos inválidos\n";
+        return 1;
+    }
+
+    vector<InfoLock> elegidos;
+    for (const InfoLock& l : LOCKS)
+        if (nombre == "todos" || nombre == l.nombre) elegidos.push_back(l);
+    if (elegidos.empty()) {
+        cerr << "Lock desconocido: " << nombre << "\n";
+        return 1;
+    }
+
+    vector<int> cantidades;
+    for (int h = 1; h < max_hilos; h *= 2) cantidades.push_back(h);
+    cantidades.push_back(max_hilos);
+
+    if (op.formato == "csv")
+        cout << "lock,hilos,ops_por_hilo,dentro,fuera,mops_s,ns_adquisicion,ns_relevo\n";
+    else
+        cout << "Núcleos: " << thread::hardware_concurrency() << ", ops/hilo: " << op.ops
+             << ", relevos: " << op.relevos << ", pausas dentro/fuera: " << op.dentro << "/" << op.fuera << "\n\n"
+             << left << setw(9) << "lock" << right << setw(6) << "hilos" << setw(12) << "Mops/s"
+             << setw(14) << "ns/adquis." << setw(14) << "ns/relevo" << "\n";
+
+    bool todo_bien = true;
+    for (const InfoLock& l : elegidos) {
+        for (int h : cantidades) {
+            Resultado r = l.f(h, op);
+            todo_bien = todo_bien && r.correcto;
+            if (op.formato == "csv")
+                cout << l.nombre << "," << h << "," << op.ops << "," << op.dentro << "," << op.fuera << ","
+                     << r.mops_s << "," << r.ns_adquisicion << "," << r.ns_relevo << "\n";
+            else
+                cout << left << setw(9) << l.nombre << right << setw(6) << h << fixed << setprecision(2)
+                     << setw(12) << r.mops_s << setw(14) << r.ns_adquisicion << setw(14) << r.ns_relevo
+                     << (r.correcto ? "" : "   ¡contador incorrecto!") << "\n";
+        }
+    }
+    return todo_bien ? 0 : 2;
+}
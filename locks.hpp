@@ -0,0 +1,250 @@
+/*
+ * Biblioteca de locks de espera activa y de cola (C++17, Linux x86-64)
+ * La usan pi_mt.cpp, lock_bench.cpp y ListCoarse/ListFine en
+ * lab_lunes13_Oc/pthread.cpp.
+ *
+ * Todos cumplen BasicLockable (lock/unlock), así que sirven con
+ * std::lock_guard / std::unique_lock en lugar de std::mutex:
+ *   LockTAS      test-and-set con backoff exponencial
+ *   LockTTAS     test-and-test-and-set: gira leyendo (la línea queda
+ *                compartida en caché) y sólo intenta el exchange si está libre
+ *   LockTicket   FIFO: toma un número y espera a que lo atiendan; el backoff
+ *                es proporcional a cuántos tiene delante
+ *   LockMCS      cola enlazada; cada hilo gira sobre su propio nodo, así que un
+ *                unlock invalida una sola línea de caché
+ *   LockCLH      cola implícita; cada hilo gira sobre el nodo del predecesor
+ *   LockHibrido  gira un rato y después duerme en un futex (como el mutex de
+ *                glibc, sin los atributos); 0 libre, 1 tomado, 2 con esperas
+ *
+ * Con más hilos que núcleos girar es inútil: el dueño del lock (o el siguiente
+ * en la cola) puede no estar corriendo. Por eso las esperas ceden la CPU con
+ * yield pasadas unas cuantas vueltas.
+ */
+
+#ifndef LOCKS_HPP
+#define LOCKS_HPP
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <immintrin.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace locks_detalle {
+
+// Espera activa: pause hasta LIMITE vueltas (unos microsegundos), luego yield.
+struct Espera {
+    static constexpr int LIMITE = 256;
+    int vueltas = 0;
+    void operator()() {
+        if (++vueltas < LIMITE) _mm_pause();
+        else std::this_thread::yield();
+    }
+};
+
+// Backoff exponencial con techo: cada fallo duplica las pausas.
+struct Backoff {
+    static constexpr int MAXIMO = 1 << 10;
+    int limite = 4;
+    void operator()() {
+        for (int i = 0; i < limite; i++) _mm_pause();
+        if (limite < MAXIMO) limite *= 2;
+        else std::this_thread::yield();
+    }
+};
+
+// Nodo de cola de MCS/CLH, uno por línea de caché.
+struct alignas(64) NodoCola {
+    std::atomic<NodoCola*> sig{nullptr};
+    std::atomic<bool> bloqueado{false};
+};
+
+// Nodos libres del hilo. Un hilo puede tener varios locks tomados a la vez
+// (ListFine sostiene dos nodos en lock coupling), así que no alcanza con un
+// nodo thread_local por hilo.
+struct NodosLibres {
+    std::vector<NodoCola*> libres;
+    ~NodosLibres() { for (NodoCola* n : libres) delete n; }
+    NodoCola* sacar() {
+        if (libres.empty()) return new NodoCola;
+        NodoCola* n = libres.back();
+        libres.pop_back();
+        return n;
+    }
+    void devolver(NodoCola* n) { libres.push_back(n); }
+};
+
+inline NodosLibres& nodos_libres() {
+    thread_local NodosLibres p;
+    return p;
+}
+
+} // namespace locks_detalle
+
+class LockTAS {
+    std::atomic<bool> tomado{false};
+public:
+    void lock() {
+        locks_detalle::Backoff espera;
+        while (tomado.exchange(true, std::memory_order_acquire)) espera();
+    }
+    bool try_lock() { return !tomado.exchange(true, std::memory_order_acquire); }
+    void unlock() { tomado.store(false, std::memory_order_release); }
+};
+
+class LockTTAS {
+    std::atomic<bool> tomado{false};
+public:
+    void lock() {
+        locks_detalle::Backoff espera;
+        while (true) {
+            locks_detalle::Espera giro;
+            while (tomado.load(std::memory_order_relaxed)) giro();
+            if (!tomado.exchange(true, std::memory_order_acquire)) return;
+            espera();   // otro ganó la carrera: retrocede antes de volver a leer
+        }
+    }
+    bool try_lock() {
+        return !tomado.load(std::memory_order_relaxed) && !tomado.exchange(true, std::memory_order_acquire);
+    }
+    void unlock() { tomado.store(false, std::memory_order_release); }
+};
+
+class LockTicket {
+    std::atomic<unsigned> siguiente{0}, atendiendo{0};
+public:
+    void lock() {
+        unsigned mio = siguiente.fetch_add(1, std::memory_order_relaxed);
+        locks_detalle::Espera giro;
+        while (true) {
+            unsigned actual = atendiendo.load(std::memory_order_acquire);
+            if (actual == mio) return;
+            if (giro.vueltas < locks_detalle::Espera::LIMITE)
+                for (unsigned i = 0, n = (mio - actual - 1) * 16; i < n; i++) _mm_pause();
+            giro();
+        }
+    }
+    bool try_lock() {
+        unsigned actual = atendiendo.load(std::memory_order_relaxed);
+        unsigned esperado = actual;
+        return siguiente.compare_exchange_strong(esperado, actual + 1, std::memory_order_acquire);
+    }
+    void unlock() {
+        // Sólo el dueño escribe atendiendo: basta load + store.
+        atendiendo.store(atendiendo.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+class LockMCS {
+    using Nodo = locks_detalle::NodoCola;
+    std::atomic<Nodo*> cola{nullptr};
+    Nodo* dueno = nullptr;   // nodo de quien tiene el lock; sólo lo usa el dueño
+public:
+    void lock() {
+        Nodo* yo = locks_detalle::nodos_libres().sacar();
+        yo->sig.store(nullptr, std::memory_order_relaxed);
+        yo->bloqueado.store(true, std::memory_order_relaxed);
+        Nodo* pred = cola.exchange(yo, std::memory_order_acq_rel);
+        if (pred) {
+            pred->sig.store(yo, std::memory_order_release);
+            locks_detalle::Espera giro;
+            while (yo->bloqueado.load(std::memory_order_acquire)) giro();
+        }
+        dueno = yo;
+    }
+    bool try_lock() {
+        Nodo* yo = locks_detalle::nodos_libres().sacar();
+        yo->sig.store(nullptr, std::memory_order_relaxed);
+        Nodo* vacio = nullptr;
+        if (cola.compare_exchange_strong(vacio, yo, std::memory_order_acq_rel)) { dueno = yo; return true; }
+        locks_detalle::nodos_libres().devolver(yo);
+        return false;
+    }
+    void unlock() {
+        Nodo* yo = dueno;
+        Nodo* sig = yo->sig.load(std::memory_order_acquire);
+        if (!sig) {
+            Nodo* esperado = yo;
+            if (cola.compare_exchange_strong(esperado, nullptr, std::memory_order_acq_rel)) {
+                locks_detalle::nodos_libres().devolver(yo);
+                return;
+            }
+            // Alguien ya hizo el exchange pero todavía no se enlazó.
+            locks_detalle::Espera giro;
+            while (!(sig = yo->sig.load(std::memory_order_acquire))) giro();
+        }
+        sig->bloqueado.store(false, std::memory_order_release);
+        locks_detalle::nodos_libres().devolver(yo);
+    }
+};
+
+// Al soltar, el nodo propio queda para el sucesor (que gira sobre él) y el
+// hilo se queda con el del predecesor. El nodo que está en la cola cuando
+// nadie tiene el lock pertenece al lock.
+class LockCLH {
+    using Nodo = locks_detalle::NodoCola;
+    std::atomic<Nodo*> cola;
+    Nodo* dueno = nullptr;
+    Nodo* pred_dueno = nullptr;
+public:
+    LockCLH() : cola(new Nodo) {}
+    ~LockCLH() { delete cola.load(); }
+    LockCLH(const LockCLH&) = delete;
+    LockCLH& operator=(const LockCLH&) = delete;
+
+    void lock() {
+        Nodo* yo = locks_detalle::nodos_libres().sacar();
+        yo->bloqueado.store(true, std::memory_order_relaxed);
+        Nodo* pred = cola.exchange(yo, std::memory_order_acq_rel);
+        locks_detalle::Espera giro;
+        while (pred->bloqueado.load(std::memory_order_acquire)) giro();
+        dueno = yo;
+        pred_dueno = pred;
+    }
+    void unlock() {
+        Nodo* pred = pred_dueno;
+        dueno->bloqueado.store(false, std::memory_order_release);
+        locks_detalle::nodos_libres().devolver(pred);
+    }
+};
+
+class LockHibrido {
+    static constexpr int GIROS = 100;
+    std::atomic<int> estado{0};
+    static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex sobre atomic<int>");
+
+    void dormir() {
+        syscall(SYS_futex, reinterpret_cast<int*>(&estado), FUTEX_WAIT_PRIVATE, 2, nullptr, nullptr, 0);
+    }
+    void despertar() {
+        syscall(SYS_futex, reinterpret_cast<int*>(&estado), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+public:
+    void lock() {
+        for (int i = 0; i < GIROS; i++) {
+            int libre = 0;
+            if (estado.load(std::memory_order_relaxed) == 0
+                && estado.compare_exchange_weak(libre, 1, std::memory_order_acquire))
+                return;
+            _mm_pause();
+        }
+        // Se marca 2 (hay esperas) para que el unlock sepa que debe despertar.
+        int c = estado.exchange(2, std::memory_order_acquire);
+        while (c != 0) {
+            dormir();
+            c = estado.exchange(2, std::memory_order_acquire);
+        }
+    }
+    bool try_lock() {
+        int libre = 0;
+        return estado.compare_exchange_strong(libre, 1, std::memory_order_acquire);
+    }
+    void unlock() {
+        if (estado.exchange(0, std::memory_order_release) == 2) despertar();
+    }
+};
+
+#endif
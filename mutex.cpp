@@ -3,7 +3,9 @@
  * ✅ Visualización clara del uso de mutex para evitar race condition
  * 
  * Compilar: g++ -g -Wall -o pi_mutex_visual pi_mutex_visual.cpp -lpthread
- * Ejecutar: ./pi_mutex_visual <num_threads> <num_terminos>
+ * Ejecutar: ./pi_mutex_visual <num_threads> <num_terminos> [kernel]
+ *   kernel: escalar (por defecto) | pares | avx2 | avx2-rcp | avx512 | avx512-rcp |
+ *           auto (leibniz.hpp); cada hilo lo aplica a su bloque de términos
  */
 
 #include <iostream>
@@ -11,6 +13,8 @@
 #include <cstdlib>
 #include <cmath>
 #include <chrono>
+#include <string>
+#include "leibniz.hpp"
 
 using namespace std;
 using namespace chrono;
@@ -18,6 +22,7 @@ using namespace chrono;
 // Variables globales
 long long n;
 int thread_count;
+InfoLeibniz kernel;     // kernel de leibniz.hpp para la suma local
 double sum = 0.0;
 pthread_mutex_t mutex;  // 🔒 Mutex global para proteger la suma
 
@@ -28,11 +33,7 @@ void* Thread_sum(void* rank) {
     long long my_last_i = my_first_i + my_n;
 
     // 1. Cálculo de suma parcial local
-    double my_sum = 0.0;
-    for (long long i = my_first_i; i < my_last_i; i++) {
-        double factor = (i % 2 == 0) ? 1.0 : -1.0;
-        my_sum += factor / (2 * i + 1);
-    }
+    double my_sum = kernel.f(my_first_i, my_last_i);
 
     printf("🧮 Hilo %ld terminó su suma local: %.6f\n", my_rank, my_sum);
 
@@ -51,13 +52,19 @@ void* Thread_sum(void* rank) {
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        cerr << "Uso: " << argv[0] << " <num_threads> <num_terminos>\n";
+    if (argc != 3 && argc != 4) {
+        cerr << "Uso: " << argv[0] << " <num_threads> <num_terminos> [kernel]\n";
         return 1;
     }
 
     thread_count = atoi(argv[1]);
     n = atoll(argv[2]);
+    string nombre = argc == 4 ? argv[3] : "escalar";
+    kernel = elegir_leibniz(nombre);
+    if (!kernel.f) {
+        cerr << "Kernel desconocido o no soportado por esta CPU: " << nombre << "\n";
+        return 1;
+    }
 
     pthread_t* thread_handles = new pthread_t[thread_count];
     pthread_mutex_init(&mutex, NULL);  // Inicializa el mutex
@@ -77,6 +84,9 @@ int main(int argc, char* argv[]) {
     cout.precision(15);
     cout << "\n🔢 Estimación de π: " << pi_estimate << endl;
     cout << "⏱️  Tiempo de ejecución: " << elapsed.count() << " segundos" << endl;
+    cout.precision(6);
+    cout << "🚀 Términos por segundo: " << n / elapsed.count() / 1e6 << " M (kernel " << kernel.nombre << ")" << endl;
+    cout.precision(15);
     cout << "🎯 Valor real de π: " << M_PI << endl;
 
     pthread_mutex_destroy(&mutex);  // Libera el mutex
@@ -0,0 +1,122 @@
+/*
+ * Estimación de π - MPI (opcionalmente MPI + hilos)
+ * Cada proceso suma un bloque contiguo de términos (n / procesos, y uno más
+ * para los primeros n % procesos) y MPI_Reduce junta las sumas en el rango 0.
+ * Con --hilos=T cada proceso reparte su bloque entre T hilos (MPI_THREAD_FUNNELED:
+ * sólo el hilo principal llama a MPI).
+ *
+ * Compilar: mpicxx -O2 -std=c++17 -Wall -o pi_mpi pi_mpi.cpp -lpthread
+ * Ejecutar: mpirun -np <procesos> ./pi_mpi <num_terminos> [--hilos=T] [--kernel=K]
+ *   --kernel=escalar|pares|avx2|avx2-rcp|avx512|avx512-rcp|auto (leibniz.hpp),
+ *     por defecto escalar, el mismo bucle que secuencial.cpp
+ * Ejemplo:   mpirun -np 4 ./pi_mpi 400000000
+ *            mpirun -np 2 ./pi_mpi 400000000 --hilos=2 --kernel=auto
+ *   En una sola máquina Open MPI usa memoria compartida (vader) entre procesos;
+ *   si hay menos núcleos que procesos hace falta --oversubscribe.
+ *
+ * Tiempos (el máximo entre procesos, que es lo que limita):
+ *   cálculo        suma local del bloque
+ *   comunicación   MPI_Reduce, incluida la espera a los procesos más lentos
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mpi.h>
+#include "leibniz.hpp"
+
+using namespace std;
+
+// Bloque [first, last) de la parte p de un total de `total` repartido en `partes`.
+void Bloque(long long total, int partes, int p, long long& first, long long& last) {
+    long long base = total / partes, resto = total % partes;
+    first = p * base + min<long long>(p, resto);
+    last = first + base + (p < resto ? 1 : 0);
+}
+
+int main(int argc, char* argv[]) {
+    int provisto;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provisto);
+    int rank, procesos;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &procesos);
+
+    // Todos los procesos validan los mismos argumentos; sólo el 0 avisa.
+    string error;
+    long long n = 0;
+    int hilos = 1;
+    string nombre_kernel = "escalar";
+    if (argc < 2) {
+        error = string("Uso: mpirun -np <procesos> ") + argv[0] + " <num_terminos> [--hilos=T] [--kernel=K]";
+    } else {
+        n = atoll(argv[1]);
+        for (int a = 2; a < argc && error.empty(); a++) {
+            string op = argv[a];
+            if (op.rfind("--hilos=", 0) == 0) hilos = atoi(op.c_str() + 8);
+            else if (op.rfind("--kernel=", 0) == 0) nombre_kernel = op.substr(9);
+            else error = "Opción desconocida: " + op;
+        }
+    }
+    InfoLeibniz kernel = elegir_leibniz(nombre_kernel);
+    if (error.empty() && (n < 0 || hilos < 1)) error = "num_terminos debe ser >= 0 y --hilos >= 1";
+    if (error.empty() && !kernel.f) error = "Kernel desconocido o no soportado por esta CPU: " + nombre_kernel;
+    if (error.empty() && hilos > 1 && provisto < MPI_THREAD_FUNNELED) error = "La biblioteca MPI no soporta MPI_THREAD_FUNNELED";
+    if (!error.empty()) {
+        if (rank == 0) cerr << error << "\n";
+        MPI_Finalize();
+        return 1;
+    }
+
+    long long my_first_i, my_last_i;
+    Bloque(n, procesos, rank, my_first_i, my_last_i);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+
+    double my_sum = 0.0;
+    if (hilos == 1) {
+        my_sum = kernel.f(my_first_i, my_last_i);
+    } else {
+        vector<double> parciales(hilos);
+        vector<thread> pool;
+        for (int t = 0; t < hilos; t++)
+            pool.emplace_back([&, t] {
+                long long f, l;
+                Bloque(my_last_i - my_first_i, hilos, t, f, l);
+                parciales[t] = kernel.f(my_first_i + f, my_first_i + l);
+            });
+        for (auto& th : pool) th.join();
+        for (double p : parciales) my_sum += p;
+    }
+
+    double t1 = MPI_Wtime();
+    double sum = 0.0;
+    MPI_Reduce(&my_sum, &sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    double t2 = MPI_Wtime();
+
+    double mis_tiempos[3] = {t1 - t0, t2 - t1, t2 - t0}, max_tiempos[3];
+    MPI_Reduce(mis_tiempos, max_tiempos, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        double pi_estimate = 4.0 * sum;
+        double total = max_tiempos[2];
+        cout.precision(15);
+        cout << "Procesos: " << procesos << ", hilos por proceso: " << hilos
+             << ", kernel: " << kernel.nombre << ", términos: " << n << endl;
+        cout << "\n🔢 Estimación de π: " << pi_estimate << endl;
+        cout << "⏱️  Tiempo de ejecución: " << total << " segundos" << endl;
+        cout.precision(6);
+        cout << "   cálculo (máx): " << max_tiempos[0] << " s, comunicación (máx): " << max_tiempos[1]
+             << " s (" << 100.0 * max_tiempos[1] / (max_tiempos[0] + max_tiempos[1]) << " %)" << endl;
+        cout << "🚀 Términos por segundo: " << n / total / 1e6 << " M" << endl;
+        cout.precision(15);
+        cout << "🎯 Valor real de π: " << M_PI << endl;
+        cout << "📏 Error absoluto: " << fabs(pi_estimate - M_PI) << endl;
+    }
+
+    MPI_Finalize();
+    return 0;
+}
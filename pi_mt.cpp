@@ -0,0 +1,259 @@
+/*
+ * Estimación de π - Pthreads con estrategia de reducción configurable
+ * Mismo kernel (serie de Leibniz) que secuencial.cpp, busy_waiting1/2.cpp y
+ * mutex.cpp; solo cambia cómo se combinan las sumas de los hilos, así se mide
+ * el costo real de cada mecanismo de sincronización.
+ *
+ * Compilar: g++ -O2 -Wall -o pi_mt pi_mt.cpp -lpthread
+ * Ejecutar: ./pi_mt <estrategia> <num_threads> <num_terminos> [--kernel=K] [--lock=L]
+ *   estrategia:
+ *     busy-dentro   turno con bandera en CADA término (como busy_waiting1)
+ *     busy-fuera    suma local y una espera de turno al final (busy_waiting2)
+ *     mutex-dentro  lock (pthread_mutex_t por defecto) en cada término
+ *     mutex         suma local y un lock al final (como mutex.cpp)
+ *     cas-dentro    compare-and-swap sobre el double global en cada término
+ *     cas           suma local y un compare-and-swap al final
+ *     arbol         parciales por hilo en líneas de caché separadas y
+ *                   reducción en árbol (log2(threads) pasos, sin locks)
+ *   --kernel=escalar|pares|avx2|avx2-rcp|avx512|avx512-rcp|auto (leibniz.hpp)
+ *     Kernel de la suma local; por defecto escalar, el bucle original. Las
+ *     estrategias *-dentro sincronizan término a término y siempre usan el
+ *     término escalar.
+ *   --lock=pthread|tas|ttas|ticket|mcs|clh|hibrido (locks.hpp)
+ *     Lock de mutex y mutex-dentro; por defecto pthread_mutex_t.
+ * Ejemplo:   ./pi_mt arbol 4 100000000
+ *            ./pi_mt arbol 4 100000000 --kernel=auto
+ *            ./pi_mt mutex-dentro 4 1000000 --lock=mcs
+ *
+ * Los programas originales quedan como demostración de clase; este reparte
+ * también el resto n % threads (los primeros hilos toman un término más).
+ */
+
+#include <iostream>
+#include <pthread.h>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <immintrin.h>
+#include "leibniz.hpp"
+#include "locks.hpp"
+
+using namespace std;
+using namespace chrono;
+
+// Variables globales compartidas
+long long n;                    // Total de términos
+int thread_count;               // Número de hilos
+string estrategia;
+InfoLeibniz kernel;             // Suma local (estrategias que no son *-dentro)
+
+double sum = 0.0;               // Suma global (busy-*, mutex*)
+atomic<int> flag(0);            // Turno (busy-*): atómico para que el compilador no saque la lectura del bucle
+pthread_mutex_t mutex;          // mutex* con --lock=pthread
+atomic<double> sum_atomica(0.0);// cas*
+
+// mutex*: el lock elegido con --lock se toma y suelta por estos punteros,
+// así Thread_sum no depende del tipo.
+template <class L> L lock_global;
+template <class L> void Tomar() { lock_global<L>.lock(); }
+template <class L> void Soltar() { lock_global<L>.unlock(); }
+void Tomar_pthread() { pthread_mutex_lock(&mutex); }
+void Soltar_pthread() { pthread_mutex_unlock(&mutex); }
+void (*Tomar_lock)() = Tomar_pthread;
+void (*Soltar_lock)() = Soltar_pthread;
+
+// Devuelve false si el nombre no corresponde a ningún lock.
+bool Elegir_lock(const string& nombre) {
+    if (nombre == "pthread") { Tomar_lock = Tomar_pthread; Soltar_lock = Soltar_pthread; }
+    else if (nombre == "tas") { Tomar_lock = Tomar<LockTAS>; Soltar_lock = Soltar<LockTAS>; }
+    else if (nombre == "ttas") { Tomar_lock = Tomar<LockTTAS>; Soltar_lock = Soltar<LockTTAS>; }
+    else if (nombre == "ticket") { Tomar_lock = Tomar<LockTicket>; Soltar_lock = Soltar<LockTicket>; }
+    else if (nombre == "mcs") { Tomar_lock = Tomar<LockMCS>; Soltar_lock = Soltar<LockMCS>; }
+    else if (nombre == "clh") { Tomar_lock = Tomar<LockCLH>; Soltar_lock = Soltar<LockCLH>; }
+    else if (nombre == "hibrido") { Tomar_lock = Tomar<LockHibrido>; Soltar_lock = Soltar<LockHibrido>; }
+    else return false;
+    return true;
+}
+
+// arbol: un parcial por hilo, cada uno en su propia línea de caché para que
+// las escrituras de un hilo no invaliden la línea de los vecinos.
+struct alignas(64) Parcial {
+    double valor;
+    atomic<int> listo;
+};
+Parcial* parciales;
+
+// Rango [first, last) del hilo: n / threads términos y uno más para los
+// primeros n % threads hilos.
+void Rango(long my_rank, long long& my_first_i, long long& my_last_i) {
+    long long base = n / thread_count, resto = n % thread_count;
+    my_first_i = my_rank * base + min<long long>(my_rank, resto);
+    my_last_i = my_first_i + base + (my_rank < resto ? 1 : 0);
+}
+
+inline double Termino(long long i) {
+    double factor = (i % 2 == 0) ? 1.0 : -1.0;
+    return factor / (2 * i + 1);
+}
+
+double Suma_local(long long my_first_i, long long my_last_i) {
+    return kernel.f(my_first_i, my_last_i);
+}
+
+// sum_atomica += v con compare-and-swap (no hay fetch_add de double antes de C++20)
+inline void Sumar_cas(double v) {
+    double actual = sum_atomica.load(memory_order_relaxed);
+    while (!sum_atomica.compare_exchange_weak(actual, actual + v, memory_order_relaxed)) {}
+}
+
+// Misma espera que arbol y los locks (locks.hpp): pause y, tras unas
+// vueltas, yield; con más hilos que núcleos el dueño del turno puede no
+// estar corriendo y el giro puro tarda un quantum.
+inline void Esperar_turno(long my_rank) {
+    locks_detalle::Espera giro;
+    while (flag.load(memory_order_acquire) != my_rank) giro();
+}
+
+inline void Pasar_turno() {
+    flag.store((flag.load(memory_order_relaxed) + 1) % thread_count, memory_order_release);
+}
+
+void* Thread_sum(void* rank) {
+    long my_rank = (long) rank;
+    long long my_first_i, my_last_i;
+    Rango(my_rank, my_first_i, my_last_i);
+
+    if (estrategia == "busy-dentro") {
+        // El turno rota en cada término: todos los hilos deben dar el mismo
+        // número de vueltas, así que los que tienen un término menos pasan
+        // el turno una vez más sin sumar.
+        long long vueltas = n / thread_count + (n % thread_count ? 1 : 0);
+        for (long long k = 0; k < vueltas; k++) {
+            Esperar_turno(my_rank);
+            if (my_first_i + k < my_last_i) sum += Termino(my_first_i + k);
+            Pasar_turno();
+        }
+    } else if (estrategia == "busy-fuera") {
+        double my_sum = Suma_local(my_first_i, my_last_i);
+        Esperar_turno(my_rank);
+        sum += my_sum;
+        Pasar_turno();
+    } else if (estrategia == "mutex-dentro") {
+        for (long long i = my_first_i; i < my_last_i; i++) {
+            Tomar_lock();
+            sum += Termino(i);
+            Soltar_lock();
+        }
+    } else if (estrategia == "mutex") {
+        double my_sum = Suma_local(my_first_i, my_last_i);
+        Tomar_lock();
+        sum += my_sum;
+        Soltar_lock();
+    } else if (estrategia == "cas-dentro") {
+        for (long long i = my_first_i; i < my_last_i; i++)
+            Sumar_cas(Termino(i));
+    } else if (estrategia == "cas") {
+        Sumar_cas(Suma_local(my_first_i, my_last_i));
+    } else {   // arbol
+        // En el paso s (s = 1, 2, 4, ...) el hilo r con r % 2s == 0 espera a
+        // r + s y suma su parcial; el resto publica el suyo y termina. Al
+        // final el hilo 0 tiene el total.
+        parciales[my_rank].valor = Suma_local(my_first_i, my_last_i);
+        for (long s = 1; s < thread_count; s *= 2) {
+            if (my_rank % (2 * s) != 0) break;
+            long socio = my_rank + s;
+            if (socio < thread_count) {
+                // Pause y después yield (locks.hpp): con más hilos que núcleos
+                // el socio puede no estar corriendo.
+                locks_detalle::Espera giro;
+                while (!parciales[socio].listo.load(memory_order_acquire)) giro();
+                parciales[my_rank].valor += parciales[socio].valor;
+            }
+        }
+        parciales[my_rank].listo.store(1, memory_order_release);
+    }
+    return NULL;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "Uso: " << argv[0] << " <estrategia> <num_threads> <num_terminos> [--kernel=K] [--lock=L]\n"
+             << "  estrategia: busy-dentro | busy-fuera | mutex-dentro | mutex | cas-dentro | cas | arbol\n"
+             << "  kernel: escalar | pares | avx2 | avx2-rcp | avx512 | avx512-rcp | auto\n"
+             << "  lock: pthread | tas | ttas | ticket | mcs | clh | hibrido\n";
+        return 1;
+    }
+
+    estrategia = argv[1];
+    thread_count = atoi(argv[2]);
+    n = atoll(argv[3]);
+    if (estrategia != "busy-dentro" && estrategia != "busy-fuera" && estrategia != "mutex-dentro"
+        && estrategia != "mutex" && estrategia != "cas-dentro" && estrategia != "cas" && estrategia != "arbol") {
+        cerr << "Estrategia desconocida: " << estrategia << "\n";
+        return 1;
+    }
+    string nombre_kernel = "escalar", nombre_lock = "pthread";
+    for (int a = 4; a < argc; a++) {
+        string opcion = argv[a];
+        if (opcion.rfind("--kernel=", 0) == 0) nombre_kernel = opcion.substr(9);
+        else if (opcion.rfind("--lock=", 0) == 0) nombre_lock = opcion.substr(7);
+        else {
+            cerr << "Opción desconocida: " << opcion << "\n";
+            return 1;
+        }
+    }
+    if (!Elegir_lock(nombre_lock)) {
+        cerr << "Lock desconocido: " << nombre_lock << "\n";
+        return 1;
+    }
+    kernel = elegir_leibniz(nombre_kernel);
+    if (!kernel.f) {
+        cerr << "Kernel desconocido o no soportado por esta CPU: " << nombre_kernel << "\n";
+        return 1;
+    }
+    if (thread_count < 1 || n < 0) {
+        cerr << "num_threads debe ser >= 1 y num_terminos >= 0\n";
+        return 1;
+    }
+
+    pthread_t* thread_handles = new pthread_t[thread_count];
+    pthread_mutex_init(&mutex, NULL);
+    parciales = new Parcial[thread_count];
+    for (int t = 0; t < thread_count; t++) {
+        parciales[t].valor = 0.0;
+        parciales[t].listo.store(0);
+    }
+
+    auto start = high_resolution_clock::now();
+
+    for (long thread = 0; thread < thread_count; thread++)
+        pthread_create(&thread_handles[thread], NULL, Thread_sum, (void*) thread);
+
+    for (int thread = 0; thread < thread_count; thread++)
+        pthread_join(thread_handles[thread], NULL);
+
+    auto end = high_resolution_clock::now();
+    auto elapsed = duration_cast<duration<double>>(end - start);
+
+    double total = estrategia.rfind("cas", 0) == 0 ? sum_atomica.load()
+                 : estrategia == "arbol"            ? parciales[0].valor
+                                                    : sum;
+    double pi_estimate = 4.0 * total;
+    cout.precision(15);
+    bool por_termino = estrategia.find("-dentro") != string::npos;
+    cout << "Estrategia: " << estrategia << ", kernel: " << (por_termino ? "escalar" : kernel.nombre)
+         << (estrategia.rfind("mutex", 0) == 0 ? ", lock: " + nombre_lock : string())
+         << ", hilos: " << thread_count << ", términos: " << n << endl;
+    cout << "\n🔢 Estimación de π: " << pi_estimate << endl;
+    cout << "⏱️  Tiempo de ejecución: " << elapsed.count() << " segundos" << endl;
+    cout << "🚀 Términos por segundo: " << n / elapsed.count() / 1e6 << " M" << endl;
+    cout << "🎯 Valor real de π: " << M_PI << endl;
+    cout << "📏 Error absoluto: " << fabs(pi_estimate - M_PI) << endl;
+
+    pthread_mutex_destroy(&mutex);
+    delete[] parciales;
+    delete[] thread_handles;
+    return 0;
+}
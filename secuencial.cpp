@@ -1,43 +1,64 @@
 /*
  * Estimación de PI - Versión Secuencial
- * 
- * Compilación: g++ -g -Wall -o pi_seq pi_seq.cpp
- * Ejecución:   ./pi_seq <número_de_terminos>
+ *
+ * Compilación: g++ -O2 -Wall -o pi_seq secuencial.cpp
+ * Ejecución:   ./pi_seq <número_de_terminos> [kernel]
+ *   kernel: escalar (por defecto, el bucle original) | pares | avx2 | avx2-rcp
+ *           | avx512 | avx512-rcp | auto | todos (corre todos y compara)
+ *   Los kernels están en leibniz.hpp.
  * Ejemplo:     ./pi_seq 100000000
+ *              ./pi_seq 100000000 todos
  */
 
 #include <iostream>
 #include <cstdlib>
 #include <cmath>
 #include <chrono>
+#include <string>
+#include <vector>
+#include "leibniz.hpp"
 
 using namespace std;
 using namespace chrono;
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        cerr << "Uso: " << argv[0] << " <número_de_terminos>\n";
+    if (argc != 2 && argc != 3) {
+        cerr << "Uso: " << argv[0] << " <número_de_terminos> [kernel]\n";
         exit(1);
     }
 
     long long n = atoll(argv[1]);
-    double sum = 0.0;
+    string nombre = argc == 3 ? argv[2] : "escalar";
 
-    auto start = high_resolution_clock::now();
-
-    for (long long i = 0; i < n; i++) {
-        double factor = (i % 2 == 0) ? 1.0 : -1.0;
-        sum += factor / (2 * i + 1);
+    vector<InfoLeibniz> kernels;
+    if (nombre == "todos") {
+        kernels = kernels_leibniz();
+    } else {
+        InfoLeibniz k = elegir_leibniz(nombre);
+        if (!k.f) {
+            cerr << "Kernel desconocido o no soportado por esta CPU: " << nombre << "\n";
+            exit(1);
+        }
+        kernels.push_back(k);
     }
 
-    double pi_estimate = 4.0 * sum;
+    cout.precision(15);
+    for (const InfoLeibniz& k : kernels) {
+        auto start = high_resolution_clock::now();
 
-    auto end = high_resolution_clock::now();
-    auto elapsed = duration_cast<duration<double>>(end - start);
+        double sum = k.f(0, n);
+        double pi_estimate = 4.0 * sum;
 
-    cout.precision(15);
-    cout << "Estimación de π: " << pi_estimate << endl;
-    cout << "Tiempo de ejecución: " << elapsed.count() << " segundos" << endl;
+        auto end = high_resolution_clock::now();
+        auto elapsed = duration_cast<duration<double>>(end - start);
+
+        if (kernels.size() > 1) cout << "\n[" << k.nombre << "]" << endl;
+        else if (nombre != "escalar") cout << "Kernel: " << k.nombre << endl;
+        cout << "Estimación de π: " << pi_estimate << endl;
+        cout << "Tiempo de ejecución: " << elapsed.count() << " segundos" << endl;
+        cout << "Términos por segundo: " << n / elapsed.count() / 1e6 << " M" << endl;
+        cout << "Error absoluto: " << fabs(pi_estimate - M_PI) << endl;
+    }
 
     return 0;
 }